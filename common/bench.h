@@ -0,0 +1,399 @@
+#pragma once
+
+// Спільний каркас для замірів у лабораторних (lab_2, lab_4, lab_5):
+// прогрів, повторні вибірки, медіана / p95 / стандартне відхилення,
+// бар'єри проти викидання роботи компілятором, прив'язка потоку до ядра
+// та запис результатів у CSV / JSON.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <intrin.h>
+#elif defined(__linux__)
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+struct Options {
+    size_t warmup = 2;       // прогрівальні запуски, що не потрапляють у статистику
+    size_t samples = 15;     // кількість вибірок
+    size_t iterations = 1;   // викликів f() в одній вибірці (час ділиться на це число)
+    int pin_cpu = -1;        // ядро для поточного потоку, -1 — не прив'язувати
+};
+
+struct Stats {
+    std::string name;
+    size_t samples = 0;
+    double mean = 0;
+    double median = 0;
+    double p95 = 0;
+    double stddev = 0;
+    double min = 0;
+    double max = 0;
+};
+
+// не дає компілятору викинути обчислення, результат якого ніде не використовується
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(_MSC_VER)
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// змушує вважати, що вся пам'ять могла бути прочитана / змінена
+inline void clobber_memory() {
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
+
+// прив'язує потік (std::thread::native_handle()) до ядра cpu; false, якщо платформа не дозволила
+template <typename Handle>
+bool pin_thread(Handle thread, int cpu) {
+    if (cpu < 0) return false;
+#if defined(_WIN32)
+    return SetThreadAffinityMask(HANDLE(thread), DWORD_PTR(1) << cpu) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    return false;
+#endif
+}
+
+// знімає прив'язку: потік знову може виконуватися на будь-якому ядрі
+template <typename Handle>
+bool unpin_thread(Handle thread) {
+#if defined(_WIN32)
+    DWORD_PTR process_mask = 0, system_mask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) return false;
+    return SetThreadAffinityMask(HANDLE(thread), process_mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return false;
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    return false;
+#endif
+}
+
+inline bool pin_current_thread(int cpu) {
+#if defined(_WIN32)
+    return pin_thread(GetCurrentThread(), cpu);
+#elif defined(__linux__)
+    return pin_thread(pthread_self(), cpu);
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// прив'язує поточний потік до ядра cpu на час свого життя; деструктор повертає
+// маску, що була до прив'язки, тож наступні заміри й створені потоки її не успадковують
+class ScopedPin {
+public:
+    explicit ScopedPin(int cpu) {
+        if (cpu < 0) return;
+#if defined(_WIN32)
+        previous = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+        active = previous != 0;
+#elif defined(__linux__)
+        active = pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous) == 0
+            && pin_current_thread(cpu);
+#endif
+    }
+
+    ~ScopedPin() {
+        if (!active) return;
+#if defined(_WIN32)
+        SetThreadAffinityMask(GetCurrentThread(), previous);
+#elif defined(__linux__)
+        pthread_setaffinity_np(pthread_self(), sizeof(previous), &previous);
+#endif
+    }
+
+    ScopedPin(const ScopedPin&) = delete;
+    ScopedPin& operator=(const ScopedPin&) = delete;
+
+    bool pinned() const { return active; }
+
+private:
+    bool active = false;
+#if defined(_WIN32)
+    DWORD_PTR previous = 0;
+#elif defined(__linux__)
+    cpu_set_t previous;
+#endif
+};
+
+// лічильник промахів кешу (PERF_COUNT_HW_CACHE_MISSES) для поточного потоку через perf_event_open;
+// на інших платформах, у VM без PMU або при забороні perf_event_paranoid available() == false
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+#if defined(__linux__)
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#if defined(__linux__)
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    bool available() const { return fd >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    // кількість промахів від start(); -1, якщо лічильник недоступний
+    long long stop() {
+#if defined(__linux__)
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd, &count, sizeof(count)) != ssize_t(sizeof(count))) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+
+private:
+    int fd = -1;
+};
+
+// гістограма затримок у стилі HDR: 64 лінійні під-кошики на кожен степінь двійки,
+// тобто відносна похибка квантиля не більша за ~1.6% на всьому діапазоні uint64.
+// record() — кілька інструкцій без алокацій; гістограми потоків зливаються через merge().
+class LatencyHistogram {
+public:
+    static constexpr int sub_bits = 6;
+    static constexpr uint64_t sub_count = uint64_t(1) << sub_bits;
+    static constexpr size_t bucket_count = size_t((64 - sub_bits + 1) * sub_count);
+
+    void record(uint64_t value) {
+        ++buckets[index_of(value)];
+        ++total;
+        if (value > max_value) max_value = value;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < bucket_count; ++i) buckets[i] += other.buckets[i];
+        total += other.total;
+        max_value = std::max(max_value, other.max_value);
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return max_value; }
+
+    // значення, не менше за яке мають частку p (0..1) записів; повертається середина кошика
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t rank = uint64_t(std::ceil(std::clamp(p, 0.0, 1.0) * double(total)));
+        if (rank == 0) rank = 1;
+        if (rank >= total) return max_value;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucket_count; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return std::min(midpoint_of(i), max_value);
+        }
+        return max_value;
+    }
+
+private:
+    static size_t index_of(uint64_t value) {
+        if (value < sub_count) return size_t(value);
+        int msb = std::bit_width(value) - 1;                 // >= sub_bits
+        int shift = msb - sub_bits;
+        return size_t((shift + 1) * sub_count + ((value >> shift) - sub_count));
+    }
+
+    static uint64_t midpoint_of(size_t index) {
+        if (index < sub_count) return index;
+        int shift = int(index / sub_count) - 1;
+        uint64_t low = (sub_count + index % sub_count) << shift;
+        return low + ((uint64_t(1) << shift) >> 1);
+    }
+
+    std::array<uint64_t, bucket_count> buckets{};
+    uint64_t total = 0;
+    uint64_t max_value = 0;
+};
+
+inline Stats summarize(const std::string& name, std::vector<double> samples_ms) {
+    Stats s;
+    s.name = name;
+    s.samples = samples_ms.size();
+    if (samples_ms.empty()) return s;
+
+    std::sort(samples_ms.begin(), samples_ms.end());
+    size_t n = samples_ms.size();
+
+    double sum = 0;
+    for (double x : samples_ms) sum += x;
+    s.mean = sum / n;
+
+    s.median = n % 2 ? samples_ms[n / 2] : (samples_ms[n / 2 - 1] + samples_ms[n / 2]) / 2;
+
+    // p95 за методом найближчого рангу
+    size_t rank = size_t(std::ceil(0.95 * n));
+    s.p95 = samples_ms[rank > 0 ? rank - 1 : 0];
+
+    double sq = 0;
+    for (double x : samples_ms) sq += (x - s.mean) * (x - s.mean);
+    s.stddev = n > 1 ? std::sqrt(sq / (n - 1)) : 0;
+
+    s.min = samples_ms.front();
+    s.max = samples_ms.back();
+    return s;
+}
+
+// журнал усіх замірів процесу; потокобезпечний, бо lab_4 міряє з кількох потоків
+class Report {
+public:
+    void add(const Stats& s) {
+        std::lock_guard<std::mutex> lock(m);
+        rows.push_back(s);
+    }
+
+    std::vector<Stats> snapshot() const {
+        std::lock_guard<std::mutex> lock(m);
+        return rows;
+    }
+
+    bool write_csv(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file.is_open()) return false;
+
+        file << "name,samples,mean_ms,median_ms,p95_ms,stddev_ms,min_ms,max_ms\n";
+        for (const auto& s : snapshot()) {
+            file << '"' << s.name << "\"," << s.samples << ',' << s.mean << ',' << s.median << ','
+                << s.p95 << ',' << s.stddev << ',' << s.min << ',' << s.max << '\n';
+        }
+        return true;
+    }
+
+    bool write_json(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file.is_open()) return false;
+
+        auto rows_copy = snapshot();
+        file << "[\n";
+        for (size_t i = 0; i < rows_copy.size(); ++i) {
+            const auto& s = rows_copy[i];
+            file << "  {\"name\": \"" << escape(s.name) << "\", \"samples\": " << s.samples
+                << ", \"mean_ms\": " << s.mean << ", \"median_ms\": " << s.median
+                << ", \"p95_ms\": " << s.p95 << ", \"stddev_ms\": " << s.stddev
+                << ", \"min_ms\": " << s.min << ", \"max_ms\": " << s.max << "}"
+                << (i + 1 < rows_copy.size() ? ",\n" : "\n");
+        }
+        file << "]\n";
+        return true;
+    }
+
+private:
+    static std::string escape(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '"' || c == '\\') result += '\\';
+            result += c;
+        }
+        return result;
+    }
+
+    mutable std::mutex m;
+    std::vector<Stats> rows;
+};
+
+inline Report& default_report() {
+    static Report report;
+    return report;
+}
+
+// виконує f() warmup разів без заміру, потім samples вибірок по iterations викликів;
+// кожна вибірка — окремий замір steady_clock у мілісекундах
+template <typename F>
+Stats run(const std::string& name, F&& f, const Options& opt = {}) {
+    using clock = std::chrono::steady_clock;
+
+    ScopedPin pin(opt.pin_cpu);   // після заміру потік знову може виконуватися на всіх ядрах
+
+    size_t iterations = opt.iterations > 0 ? opt.iterations : 1;
+
+    for (size_t i = 0; i < opt.warmup; ++i) {
+        f();
+        clobber_memory();
+    }
+
+    std::vector<double> samples_ms;
+    samples_ms.reserve(opt.samples);
+
+    for (size_t s = 0; s < opt.samples; ++s) {
+        auto start = clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            f();
+            clobber_memory();
+        }
+        auto end = clock::now();
+        samples_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count() / iterations);
+    }
+
+    Stats stats = summarize(name, std::move(samples_ms));
+    default_report().add(stats);
+    return stats;
+}
+
+inline std::ostream& operator<<(std::ostream& out, const Stats& s) {
+    return out << s.median << " ms (p95 " << s.p95 << ", sd " << s.stddev
+        << ", n=" << s.samples << ")";
+}
+
+} // namespace bench
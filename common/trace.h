@@ -0,0 +1,251 @@
+#pragma once
+
+// Легке трасування для лабораторних (lab_3, lab_5): кожен потік пише події
+// (час, тривалість, потік, назва вузла, номер дії) у власний кільцевий буфер
+// без блокувань, а колектор забирає їх у фоні або наприкінці й записує
+// у бінарний файл чи в JSON формату Chrome trace events (chrome://tracing, Perfetto).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace trace {
+
+struct Event {
+    uint64_t start_ns = 0;      // від початку трасування (now_ns)
+    uint64_t duration_ns = 0;   // 0 - миттєва подія
+    uint32_t thread = 0;        // номер буфера потоку
+    int32_t index = 0;          // номер дії в наборі
+    char name[16] = {};         // назва вузла / обчислення (обрізається до 15 символів)
+};
+
+inline uint64_t now_ns() {
+    using clock = std::chrono::steady_clock;
+    static const clock::time_point origin = clock::now();
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - origin).count());
+}
+
+// кільцевий буфер одного потоку: пише лише власник, читає лише колектор;
+// якщо колектор не встигає і буфер повний, нова подія відкидається й рахується в dropped
+class RingBuffer {
+public:
+    static constexpr size_t capacity = size_t(1) << 12;
+
+    explicit RingBuffer(uint32_t id) : id(id), slots(capacity) {}
+
+    bool push(const Event& e) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[h & (capacity - 1)] = e;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename Sink>
+    void drain(Sink&& sink) {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_acquire);
+        for (; t != h; ++t) sink(slots[t & (capacity - 1)]);
+        tail.store(h, std::memory_order_release);
+    }
+
+    const uint32_t id;
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<bool> owned{ true };   // false - потік-власник завершився, буфер можна віддати іншому
+
+private:
+    alignas(64) std::atomic<uint64_t> head{ 0 };
+    alignas(64) std::atomic<uint64_t> tail{ 0 };
+    std::vector<Event> slots;
+};
+
+// збирає події з усіх буферів; фоновий потік (start) періодично спорожнює буфери,
+// щоб вони не переповнювалися на довгих прогонах
+class Collector {
+public:
+    ~Collector() { stop(); }
+
+    // буфер для нового потоку: спершу шукаємо буфер потоку, що вже завершився
+    std::shared_ptr<RingBuffer> acquire_buffer() {
+        std::lock_guard<std::mutex> lock(m);
+        for (auto& b : buffers) {
+            bool expected = false;
+            if (b->owned.compare_exchange_strong(expected, true)) return b;
+        }
+        buffers.push_back(std::make_shared<RingBuffer>(uint32_t(buffers.size())));
+        return buffers.back();
+    }
+
+    void start(std::chrono::milliseconds interval = std::chrono::milliseconds(20)) {
+        std::lock_guard<std::mutex> lock(control);
+        if (flusher.joinable()) return;
+        running = true;
+        flusher = std::thread([this, interval] {
+            std::unique_lock<std::mutex> wait_lock(control);
+            while (running) {
+                wake.wait_for(wait_lock, interval, [this] { return !running; });
+                wait_lock.unlock();
+                drain();
+                wait_lock.lock();
+            }
+        });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(control);
+            running = false;
+        }
+        wake.notify_all();
+        if (flusher.joinable()) flusher.join();
+        drain();
+    }
+
+    // усі зібрані досі події, впорядковані за часом початку
+    std::vector<Event> events() {
+        drain();
+        std::lock_guard<std::mutex> lock(m);
+        std::vector<Event> result = collected;
+        std::stable_sort(result.begin(), result.end(),
+            [](const Event& a, const Event& b) { return a.start_ns < b.start_ns; });
+        return result;
+    }
+
+    void clear() {
+        drain();
+        std::lock_guard<std::mutex> lock(m);
+        collected.clear();
+    }
+
+    uint64_t dropped() {
+        std::lock_guard<std::mutex> lock(m);
+        uint64_t total = 0;
+        for (auto& b : buffers) total += b->dropped.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    bool write_chrome_json(const std::string& path) {
+        std::ofstream file(path);
+        if (!file.is_open()) return false;
+
+        auto all = events();
+        file << std::fixed << std::setprecision(3);   // мікросекунди з точністю до наносекунди
+        file << "{\"traceEvents\":[\n";
+        for (size_t i = 0; i < all.size(); ++i) {
+            const Event& e = all[i];
+            file << "  {\"name\":\"" << escape(e.name) << "\",\"cat\":\"lab\",\"pid\":1,\"tid\":" << e.thread
+                << ",\"ts\":" << e.start_ns / 1000.0;
+            if (e.duration_ns > 0) file << ",\"ph\":\"X\",\"dur\":" << e.duration_ns / 1000.0;
+            else file << ",\"ph\":\"i\",\"s\":\"t\"";
+            file << ",\"args\":{\"index\":" << e.index << "}}" << (i + 1 < all.size() ? ",\n" : "\n");
+        }
+        file << "],\"displayTimeUnit\":\"ms\"}\n";
+        return true;
+    }
+
+    // "TRC1", кількість подій (uint64), далі масив Event як є
+    bool write_binary(const std::string& path) {
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+
+        auto all = events();
+        uint64_t count = all.size();
+        file.write("TRC1", 4);
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(all.data()), std::streamsize(all.size() * sizeof(Event)));
+        return bool(file);
+    }
+
+private:
+    void drain() {
+        std::lock_guard<std::mutex> lock(m);
+        for (auto& b : buffers) {
+            b->drain([this](const Event& e) { collected.push_back(e); });
+        }
+    }
+
+    static std::string escape(const char* text) {
+        std::string result;
+        for (; *text; ++text) {
+            if (*text == '"' || *text == '\\') result += '\\';
+            result += *text;
+        }
+        return result;
+    }
+
+    std::mutex m;   // buffers, collected; drain буферів - лише під ним
+    std::vector<std::shared_ptr<RingBuffer>> buffers;
+    std::vector<Event> collected;
+
+    std::mutex control;
+    std::condition_variable wake;
+    bool running = false;
+    std::thread flusher;
+};
+
+inline Collector& collector() {
+    static Collector instance;
+    return instance;
+}
+
+// буфер поточного потоку; після завершення потоку повертається колектору для повторного використання
+inline RingBuffer& local_buffer() {
+    struct Holder {
+        std::shared_ptr<RingBuffer> buffer = collector().acquire_buffer();
+        ~Holder() { buffer->owned.store(false, std::memory_order_release); }
+    };
+    thread_local Holder holder;
+    return *holder.buffer;
+}
+
+inline void record(RingBuffer& buffer, std::string_view name, int index, uint64_t start_ns, uint64_t duration_ns = 0) {
+    Event e;
+    e.start_ns = start_ns;
+    e.duration_ns = duration_ns;
+    e.thread = buffer.id;
+    e.index = index;
+    std::memcpy(e.name, name.data(), std::min(name.size(), sizeof(e.name) - 1));
+    buffer.push(e);
+}
+
+inline void record(std::string_view name, int index, uint64_t start_ns, uint64_t duration_ns = 0) {
+    record(local_buffer(), name, index, start_ns, duration_ns);
+}
+
+// миттєва подія "зараз"
+inline void instant(std::string_view name, int index) {
+    record(name, index, now_ns());
+}
+
+// подія з тривалістю: від створення до знищення об'єкта; буфер береться одразу,
+// щоб події потоків, які перетинаються в часі, не потрапили в один рядок шкали
+class Scope {
+public:
+    Scope(std::string_view name, int index) : buffer(local_buffer()), name(name), index(index), start(now_ns()) {}
+    ~Scope() { record(buffer, name, index, start, now_ns() - start); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    RingBuffer& buffer;
+    std::string_view name;
+    int index;
+    uint64_t start;
+};
+
+} // namespace trace
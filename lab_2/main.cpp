@@ -1,12 +1,49 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
 #include <chrono>
+#include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
 #include <execution>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <random>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "../common/bench.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
 
 std::vector<int> generate_sorted_vector(size_t n) {
     std::mt19937 rng(std::random_device{}());
@@ -19,35 +56,429 @@ std::vector<int> generate_sorted_vector(size_t n) {
 }
 
 
-template <typename F>
-double measure_ms(F&& f, size_t iterations = 1) {
-    using namespace std::chrono;
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t workers) : queues(workers > 0 ? workers : 1) {
+        threads.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+            threads.emplace_back([this, i]() { worker_loop(i); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return threads.size(); }
+
+    size_t concurrency() const { return threads.size() + 1; }
+
+    bool pin_worker(size_t worker, int cpu) {
+        return worker < threads.size() && bench::pin_thread(threads[worker].native_handle(), cpu);
+    }
+
+    bool unpin_worker(size_t worker) {
+        return worker < threads.size() && bench::unpin_thread(threads[worker].native_handle());
+    }
+
+    template <typename F>
+    void run_tasks(size_t count, F&& f) {
+
+        std::atomic<size_t> remaining{ count };
+
+        for (size_t i = 0; i < count; ++i) {
+            push([&f, &remaining, i]() {
+                f(i);
+                remaining.fetch_sub(1, std::memory_order_release);
+                });
+        }
+
+        size_t home = next_queue.load(std::memory_order_relaxed);
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!try_run_one(home)) std::this_thread::yield();
+        }
+    }
+
+    template <typename F>
+    void run_on_workers(F&& f) {
+
+        if (threads.empty()) {
+            f(size_t(0));
+            return;
+        }
+
+        std::atomic<size_t> remaining{ threads.size() };
+
+        for (size_t w = 0; w < threads.size(); ++w) {
+            Queue& q = queues[w];
+            {
+                std::lock_guard<std::mutex> lock(q.m);
+                q.affine.push_back([&f, &remaining, w]() {
+                    f(w);
+                    remaining.fetch_sub(1, std::memory_order_release);
+                    });
+                q.affine_count.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        { std::lock_guard<std::mutex> lock(wake_mutex); }
+        wake.notify_all();
+
+        size_t home = next_queue.load(std::memory_order_relaxed);
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!try_run_one(home)) std::this_thread::yield();
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<std::function<void()>> tasks;
+        std::deque<std::function<void()>> affine;
+        std::atomic<size_t> affine_count{ 0 };
+    };
+
+    void push(std::function<void()> task) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+
+        Queue& q = queues[next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(q.m);
+            q.tasks.push_back(std::move(task));
+        }
+
+        { std::lock_guard<std::mutex> lock(wake_mutex); }
+        wake.notify_one();
+    }
+
+    bool try_run_one(size_t home) {
+        std::function<void()> task;
+
+        for (size_t k = 0; k < queues.size() && !task; ++k) {
+            Queue& q = queues[(home + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.m);
+            if (q.tasks.empty()) continue;
+
+            if (k == 0) {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            }
+            else {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+        }
+
+        if (!task) return false;
+
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+
+    bool try_run_affine(size_t id) {
+        std::function<void()> task;
+        {
+            Queue& q = queues[id];
+            std::lock_guard<std::mutex> lock(q.m);
+            if (q.affine.empty()) return false;
+
+            task = std::move(q.affine.front());
+            q.affine.pop_front();
+            q.affine_count.fetch_sub(1, std::memory_order_relaxed);
+        }
+        task();
+        return true;
+    }
+
+    void worker_loop(size_t id) {
+        std::atomic<size_t>& affine_count = queues[id].affine_count;
+
+        while (true) {
+            if (try_run_affine(id) || try_run_one(id)) continue;
+
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake.wait(lock, [this, &affine_count]() {
+                return stopping || pending.load(std::memory_order_relaxed) > 0
+                    || affine_count.load(std::memory_order_relaxed) > 0;
+                });
+            if (stopping && pending.load(std::memory_order_relaxed) == 0
+                && affine_count.load(std::memory_order_relaxed) == 0) return;
+        }
+    }
+
+    std::vector<Queue> queues;
+    std::vector<std::thread> threads;
+
+    std::atomic<size_t> next_queue{ 0 };
+    std::atomic<long> pending{ 0 };
+
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MERGE_X86_SIMD 1
+#endif
+
+#if defined(MERGE_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define MERGE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MERGE_TARGET(isa)
+#endif
+
+
+using merge_int_fn = void (*)(const int*, size_t, const int*, size_t, int*);
+
+
+void merge_int_scalar(const int* a, size_t n_a, const int* b, size_t n_b, int* out) {
+    std::merge(a, a + n_a, b, b + n_b, out);
+}
+
+
+template <size_t W>
+void merge_int_tail(const int* hi, const int* a, size_t n_a, const int* b, size_t n_b, int* out) {
+
+    const int* shrt = n_a < W ? a : b;
+    size_t n_shrt = n_a < W ? n_a : n_b;
+    const int* lng = n_a < W ? b : a;
+    size_t n_lng = n_a < W ? n_b : n_a;
+
+    int tmp[2 * W];
+    int* tmp_e = std::merge(hi, hi + W, shrt, shrt + n_shrt, tmp);
+    std::merge(tmp, tmp_e, lng, lng + n_lng, out);
+}
+
+
+#ifdef MERGE_X86_SIMD
+
+MERGE_TARGET("sse4.1")
+inline void bitonic_merge_4(__m128i& lo, __m128i& hi) {
+
+    hi = _mm_shuffle_epi32(hi, _MM_SHUFFLE(0, 1, 2, 3));
+    __m128i l = _mm_min_epi32(lo, hi);
+    __m128i h = _mm_max_epi32(lo, hi);
+
+    __m128i lp = _mm_shuffle_epi32(l, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128i hp = _mm_shuffle_epi32(h, _MM_SHUFFLE(1, 0, 3, 2));
+    l = _mm_blend_epi16(_mm_min_epi32(l, lp), _mm_max_epi32(l, lp), 0xF0);
+    h = _mm_blend_epi16(_mm_min_epi32(h, hp), _mm_max_epi32(h, hp), 0xF0);
+
+    lp = _mm_shuffle_epi32(l, _MM_SHUFFLE(2, 3, 0, 1));
+    hp = _mm_shuffle_epi32(h, _MM_SHUFFLE(2, 3, 0, 1));
+    lo = _mm_blend_epi16(_mm_min_epi32(l, lp), _mm_max_epi32(l, lp), 0xCC);
+    hi = _mm_blend_epi16(_mm_min_epi32(h, hp), _mm_max_epi32(h, hp), 0xCC);
+}
+
+
+MERGE_TARGET("sse4.1")
+void merge_int_sse41(const int* a, size_t n_a, const int* b, size_t n_b, int* out) {
+
+    constexpr size_t W = 4;
+    if (n_a < W || n_b < W) {
+        merge_int_scalar(a, n_a, b, n_b, out);
+        return;
+    }
+
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    size_t i = W, j = W;
+
+    bitonic_merge_4(lo, hi);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+    out += W;
+
+    while (i + W <= n_a && j + W <= n_b) {
+        bool take_a = a[i] <= b[j];
+        const int* src = take_a ? a + i : b + j;
+        i += take_a ? W : 0;
+        j += take_a ? 0 : W;
+
+        lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        bitonic_merge_4(lo, hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+        out += W;
+    }
+
+    alignas(16) int rest[W];
+    _mm_store_si128(reinterpret_cast<__m128i*>(rest), hi);
+    merge_int_tail<W>(rest, a + i, n_a - i, b + j, n_b - j, out);
+}
+
+
+MERGE_TARGET("avx2")
+inline __m256i bitonic_clean_8(__m256i v) {
+
+    __m256i p = _mm256_permute2x128_si256(v, v, 0x01);
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xF0);
+
+    p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xCC);
+
+    p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xAA);
+}
+
+
+MERGE_TARGET("avx2")
+inline void bitonic_merge_8(__m256i& lo, __m256i& hi) {
+
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    hi = _mm256_permutevar8x32_epi32(hi, reverse);
+
+    __m256i l = _mm256_min_epi32(lo, hi);
+    __m256i h = _mm256_max_epi32(lo, hi);
+
+    lo = bitonic_clean_8(l);
+    hi = bitonic_clean_8(h);
+}
+
+
+MERGE_TARGET("avx2")
+void merge_int_avx2(const int* a, size_t n_a, const int* b, size_t n_b, int* out) {
+
+    constexpr size_t W = 8;
+    if (n_a < W || n_b < W) {
+        merge_int_scalar(a, n_a, b, n_b, out);
+        return;
+    }
+
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    size_t i = W, j = W;
+
+    bitonic_merge_8(lo, hi);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), lo);
+    out += W;
+
+    while (i + W <= n_a && j + W <= n_b) {
+        bool take_a = a[i] <= b[j];
+        const int* src = take_a ? a + i : b + j;
+        i += take_a ? W : 0;
+        j += take_a ? 0 : W;
+
+        lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        bitonic_merge_8(lo, hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), lo);
+        out += W;
+    }
+
+    alignas(32) int rest[W];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(rest), hi);
+    merge_int_tail<W>(rest, a + i, n_a - i, b + j, n_b - j, out);
+}
+
+
+bool cpu_has_sse41() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+
+struct MergeIntKernel {
+    merge_int_fn fn;
+    const char* name;
+};
+
+
+MergeIntKernel select_merge_int_kernel() {
+#ifdef MERGE_X86_SIMD
+    if (cpu_has_avx2()) return { merge_int_avx2, "avx2 bitonic 8x32" };
+    if (cpu_has_sse41()) return { merge_int_sse41, "sse4.1 bitonic 4x32" };
+#endif
+    return { merge_int_scalar, "scalar std::merge" };
+}
+
+
+const MergeIntKernel& merge_int_kernel() {
+    static const MergeIntKernel kernel = select_merge_int_kernel();
+    return kernel;
+}
+
+
+template <typename Less, typename T>
+constexpr bool is_natural_less = std::is_same_v<Less, std::less<T>> || std::is_same_v<Less, std::less<>>;
+
+
+template <typename It1, typename It2, typename It3, typename Less = std::less<>>
+It3 merge_leaf(It1 a_b, It1 a_e, It2 b_b, It2 b_e, It3 c_b, Less less = Less()) {
 
-    auto start = high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; ++i) f();
-    auto end = high_resolution_clock::now();
+    using V1 = typename std::iterator_traits<It1>::value_type;
+    using V2 = typename std::iterator_traits<It2>::value_type;
+    using V3 = typename std::iterator_traits<It3>::value_type;
 
-    double ms = duration_cast<duration<double, std::milli>>(end - start).count();
-    return ms / iterations;
+    if constexpr (std::contiguous_iterator<It1> && std::contiguous_iterator<It2> && std::contiguous_iterator<It3>
+        && std::is_same_v<V1, int> && std::is_same_v<V2, int> && std::is_same_v<V3, int> && is_natural_less<Less, int>) {
+        size_t n_a = a_e - a_b;
+        size_t n_b = b_e - b_b;
+        merge_int_kernel().fn(std::to_address(a_b), n_a, std::to_address(b_b), n_b, std::to_address(c_b));
+        return c_b + (n_a + n_b);
+    }
+    else {
+        return std::merge(a_b, a_e, b_b, b_e, c_b, less);
+    }
 }
 
 
 template <typename It1, typename It2, typename It3>
-double benchmark_std_merge_no_policy(It1 a_b, It1 a_e, It2 b_b, It2 b_e, It3 c_b) {
-    return measure_ms([&]() {
+bench::Stats benchmark_std_merge_no_policy(const std::string& name, It1 a_b, It1 a_e, It2 b_b, It2 b_e, It3 c_b) {
+    return bench::run(name, [&]() {
         std::merge(a_b, a_e, b_b, b_e, c_b);
         });
 }
 
 
 template <typename Exec, typename It1, typename It2, typename It3>
-double benchmark_std_merge_policy(Exec&& policy, It1 a_b, It1 a_e, It2 b_b, It2 b_e, It3 c_b) {
-    return measure_ms([&]() {
+bench::Stats benchmark_std_merge_policy(const std::string& name, Exec&& policy, It1 a_b, It1 a_e, It2 b_b, It2 b_e, It3 c_b) {
+    return bench::run(name, [&]() {
         std::merge(policy, a_b, a_e, b_b, b_e, c_b);
         });
 }
 
 
+template <typename It1, typename It2, typename It3>
+bench::Stats benchmark_merge_leaf(const std::string& name, It1 a_b, It1 a_e, It2 b_b, It2 b_e, It3 c_b) {
+    return bench::run(name, [&]() {
+        merge_leaf(a_b, a_e, b_b, b_e, c_b);
+        });
+}
+
+
 void run_std_merge_benchmarks(std::ostream& out, size_t n) {
 
     out << "=== std::merge benchmarks, N=" << n << " ===\n";
@@ -56,38 +487,49 @@ void run_std_merge_benchmarks(std::ostream& out, size_t n) {
     auto B = generate_sorted_vector(n);
     std::vector<int> C(2 * n);
 
-    double no_pol = benchmark_std_merge_no_policy(A.begin(), A.end(), B.begin(), B.end(), C.begin());
-    out << "no policy:    " << no_pol << " ms\n";
+    std::string tag = "/N=" + std::to_string(n);
+
+    auto no_pol = benchmark_std_merge_no_policy("std_merge/no_policy" + tag, A.begin(), A.end(), B.begin(), B.end(), C.begin());
+    out << "no policy:    " << no_pol << "\n";
 
-    double seq = benchmark_std_merge_policy(std::execution::seq, A.begin(), A.end(), B.begin(), B.end(), C.begin());
-    out << "seq:          " << seq << " ms\n";
+    auto seq = benchmark_std_merge_policy("std_merge/seq" + tag, std::execution::seq, A.begin(), A.end(), B.begin(), B.end(), C.begin());
+    out << "seq:          " << seq << "\n";
 
-    double par = benchmark_std_merge_policy(std::execution::par, A.begin(), A.end(), B.begin(), B.end(), C.begin());
-    out << "par:          " << par << " ms\n";
+    auto par = benchmark_std_merge_policy("std_merge/par" + tag, std::execution::par, A.begin(), A.end(), B.begin(), B.end(), C.begin());
+    out << "par:          " << par << "\n";
 
-    double pun = benchmark_std_merge_policy(std::execution::par_unseq, A.begin(), A.end(), B.begin(), B.end(), C.begin());
-    out << "par_unseq:    " << pun << " ms\n";
+    auto pun = benchmark_std_merge_policy("std_merge/par_unseq" + tag, std::execution::par_unseq, A.begin(), A.end(), B.begin(), B.end(), C.begin());
+    out << "par_unseq:    " << pun << "\n";
+
+    auto leaf = benchmark_merge_leaf("merge_leaf" + tag, A.begin(), A.end(), B.begin(), B.end(), C.begin());
+    out << "simd leaf:    " << leaf << " [" << merge_int_kernel().name << "]\n";
 
     out << "\n";
 }
 
 
-double benchmark_custom_parallel_merge(size_t n, size_t K, std::ostream& out) {
+double measure_thread_spawn_ms(size_t K) {
+    return bench::run("std_thread_spawn/K=" + std::to_string(K), [K]() {
+        std::vector<std::thread> threads;
+        threads.reserve(K);
+        for (size_t i = 0; i < K; ++i) threads.emplace_back([]() {});
+        for (auto& t : threads) t.join();
+        }).median;
+}
+
+
+double benchmark_custom_parallel_merge(ThreadPool& pool, size_t n, size_t K, std::ostream& out) {
 
     auto A = generate_sorted_vector(n);
     auto B = generate_sorted_vector(n);
 
     std::vector<std::vector<int>> partial(K);
-    std::vector<std::thread> threads(K);
 
     size_t hw = std::thread::hardware_concurrency();
 
     size_t chunkA = (A.size() + K - 1) / K;
     size_t chunkB = (B.size() + K - 1) / K;
 
-    using namespace std::chrono;
-    auto start = high_resolution_clock::now();
-
     for (size_t i = 0; i < K; ++i) {
         size_t a_b = std::min(i * chunkA, A.size());
         size_t a_e = std::min((i + 1) * chunkA, A.size());
@@ -96,35 +538,88 @@ double benchmark_custom_parallel_merge(size_t n, size_t K, std::ostream& out) {
         size_t b_e = std::min((i + 1) * chunkB, B.size());
 
         partial[i].resize((a_e - a_b) + (b_e - b_b));
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    std::vector<clock::time_point> task_start(K);
+    std::vector<clock::time_point> task_end(K);
+
+    std::vector<double> dispatch_samples;
+    std::vector<double> merge_samples;
+    std::vector<double> fold_samples;
+
+    std::string name = "custom_parallel/K=" + std::to_string(K) + "/N=" + std::to_string(n);
+
+    bench::Options options;
+
+    auto stats = bench::run(name, [&]() {
+        auto start = clock::now();
 
-        threads[i] = std::thread([&, i, a_b, a_e, b_b, b_e]() {
-            std::merge(A.begin() + a_b, A.begin() + a_e,
+        pool.run_tasks(K, [&](size_t i) {
+            task_start[i] = clock::now();
+
+            size_t a_b = std::min(i * chunkA, A.size());
+            size_t a_e = std::min((i + 1) * chunkA, A.size());
+
+            size_t b_b = std::min(i * chunkB, B.size());
+            size_t b_e = std::min((i + 1) * chunkB, B.size());
+
+            merge_leaf(A.begin() + a_b, A.begin() + a_e,
                 B.begin() + b_b, B.begin() + b_e,
                 partial[i].begin());
+
+            task_end[i] = clock::now();
             });
-    }
 
-    for (auto& t : threads) t.join();
+        auto joined = clock::now();
 
-    std::vector<int> merged = partial[0];
+        std::vector<int> merged = partial[0];
 
-    for (size_t i = 1; i < K; ++i) {
-        std::vector<int> tmp(merged.size() + partial[i].size());
-        std::merge(merged.begin(), merged.end(),
-            partial[i].begin(), partial[i].end(),
-            tmp.begin());
-        merged.swap(tmp);
-    }
+        for (size_t i = 1; i < K; ++i) {
+            std::vector<int> tmp(merged.size() + partial[i].size());
+            merge_leaf(merged.begin(), merged.end(),
+                partial[i].begin(), partial[i].end(),
+                tmp.begin());
+            merged.swap(tmp);
+        }
 
-    auto end = high_resolution_clock::now();
-    double ms = duration_cast<duration<double, std::milli>>(end - start).count();
+        bench::do_not_optimize(merged.data());
 
-    out << "K=" << K << ", time_ms=" << ms << ", hw_threads=" << hw << "\n";
-    return ms;
+        auto end = clock::now();
+
+        double merge_ms = 0;
+        for (size_t i = 0; i < K; ++i) merge_ms += to_ms(task_end[i] - task_start[i]);
+
+        dispatch_samples.push_back(to_ms(*std::min_element(task_start.begin(), task_start.end()) - start));
+        merge_samples.push_back(merge_ms);
+        fold_samples.push_back(to_ms(end - joined));
+        }, options);
+
+    // перші options.warmup викликів - прогрів: bench::run їх не враховує, тож і фази теж
+    for (auto* samples : { &dispatch_samples, &merge_samples, &fold_samples })
+        samples->erase(samples->begin(), samples->begin() + std::min(options.warmup, samples->size()));
+
+    double dispatch_ms = bench::summarize("", dispatch_samples).median;
+    double merge_ms = bench::summarize("", merge_samples).median;
+    double fold_ms = bench::summarize("", fold_samples).median;
+
+    double spawn_ms = measure_thread_spawn_ms(K);
+
+    out << "K=" << K << ", time_ms=" << stats.median
+        << ", p95_ms=" << stats.p95
+        << ", sd_ms=" << stats.stddev
+        << ", dispatch_ms=" << dispatch_ms
+        << ", merge_cpu_ms=" << merge_ms
+        << ", fold_ms=" << fold_ms
+        << ", std_thread_spawn_ms=" << spawn_ms
+        << ", hw_threads=" << hw << "\n";
+    return stats.median;
 }
 
 
-void run_custom_parallel_benchmarks(std::ostream& out, size_t n) {
+void run_custom_parallel_benchmarks(ThreadPool& pool, std::ostream& out, size_t n) {
 
     out << "=== Custom Parallel Merge, N=" << n << " ===\n";
     out << "K\ttime_ms\n";
@@ -133,7 +628,7 @@ void run_custom_parallel_benchmarks(std::ostream& out, size_t n) {
     double bestTime = 1e100;
 
     for (size_t K = 1; K <= 16; ++K) {      
-        double t = benchmark_custom_parallel_merge(n, K, out);
+        double t = benchmark_custom_parallel_merge(pool, n, K, out);
         if (t < bestTime) {
             bestTime = t;
             bestK = K;
@@ -149,22 +644,1338 @@ void run_custom_parallel_benchmarks(std::ostream& out, size_t n) {
 }
 
 
-int main() {
+template <typename It1, typename It2, typename Less = std::less<>>
+size_t merge_path_co_rank(size_t diag, It1 a, size_t n_a, It2 b, size_t n_b, Less less = Less()) {
 
-    std::ofstream out("merge_results.txt");
-    if (!out.is_open()) {
-        std::cerr << "Error: cannot open merge_results.txt\n";
-        return 1;
+    size_t lo = diag > n_b ? diag - n_b : 0;
+    size_t hi = std::min(diag, n_a);
+
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (!less(b[diag - i - 1], a[i])) lo = i + 1;
+        else hi = i;
     }
+    return lo;
+}
 
-    out << "MERGE EXPERIMENTS (Release mode recommended)\n\n";
 
-    std::vector<size_t> sizes = { 100000, 300000, 1000000 };
+template <typename It1, typename It2, typename It3, typename Less = std::less<>>
+void merge_path_slice(It1 a, size_t n_a, It2 b, size_t n_b, It3 c, size_t d_b, size_t d_e, Less less = Less()) {
 
-    for (size_t n : sizes) {
-        run_std_merge_benchmarks(out, n);
-        run_custom_parallel_benchmarks(out, n);
+    size_t a_b = merge_path_co_rank(d_b, a, n_a, b, n_b, less);
+    size_t a_e = merge_path_co_rank(d_e, a, n_a, b, n_b, less);
+
+    merge_leaf(a + a_b, a + a_e,
+        b + (d_b - a_b), b + (d_e - a_e),
+        c + d_b, less);
+}
+
+
+template <typename It1, typename It2, typename It3, typename Less = std::less<>>
+void merge_path_parallel_merge(ThreadPool& pool, It1 a_b, It1 a_e, It2 b_b, It2 b_e, It3 c_b, size_t K, Less less = Less()) {
+
+    size_t n_a = a_e - a_b;
+    size_t n_b = b_e - b_b;
+    size_t total = n_a + n_b;
+
+    if (K <= 1 || total == 0) {
+        merge_leaf(a_b, a_e, b_b, b_e, c_b, less);
+        return;
+    }
+
+    pool.run_tasks(K, [=](size_t i) {
+        merge_path_slice(a_b, n_a, b_b, n_b, c_b, total * i / K, total * (i + 1) / K, less);
+        });
+}
+
+
+double benchmark_merge_path_parallel(ThreadPool& pool, const std::vector<int>& A, const std::vector<int>& B,
+    const std::vector<int>& expected, size_t K, std::ostream& out) {
+
+    std::vector<int> C(A.size() + B.size());
+    size_t hw = std::thread::hardware_concurrency();
+
+    std::string name = "merge_path/K=" + std::to_string(K) + "/N=" + std::to_string(A.size());
+
+    auto stats = bench::run(name, [&]() {
+        merge_path_parallel_merge(pool, A.begin(), A.end(), B.begin(), B.end(), C.begin(), K);
+        });
+
+    bool ok = (C == expected);
+
+    out << "K=" << K << ", time_ms=" << stats.median
+        << ", p95_ms=" << stats.p95
+        << ", sd_ms=" << stats.stddev
+        << ", hw_threads=" << hw
+        << (ok ? "" : ", MISMATCH") << "\n";
+    return stats.median;
+}
+
+
+void run_merge_path_benchmarks(ThreadPool& pool, std::ostream& out, size_t n) {
+
+    out << "=== Merge Path Parallel Merge, N=" << n << " ===\n";
+    out << "K\ttime_ms\n";
+
+    auto A = generate_sorted_vector(n);
+    auto B = generate_sorted_vector(n);
+
+    std::vector<int> expected(A.size() + B.size());
+    std::merge(A.begin(), A.end(), B.begin(), B.end(), expected.begin());
+
+    size_t hw = std::thread::hardware_concurrency();
+    size_t maxK = std::max<size_t>(16, hw);
+
+    size_t bestK = 0;
+    double bestTime = 1e100;
+    double baseTime = 0;
+
+    for (size_t K = 1; K <= maxK; ++K) {
+        double t = benchmark_merge_path_parallel(pool, A, B, expected, K, out);
+        if (K == 1) baseTime = t;
+        if (t < bestTime) {
+            bestTime = t;
+            bestK = K;
+        }
+    }
+
+    out << "\nBEST K = " << bestK
+        << ", time = " << bestTime << " ms"
+        << ", speedup vs K=1 = " << baseTime / bestTime
+        << ", hw_threads = " << hw
+        << ", ratio K/hw = " << double(bestK) / hw << "\n\n";
+}
+
+template <typename T>
+struct SortedRun {
+    const T* b;
+    const T* e;
+
+    size_t size() const { return size_t(e - b); }
+};
+
+
+template <typename T, typename Less = std::less<T>>
+class LoserTree {
+public:
+    LoserTree(const std::vector<SortedRun<T>>& runs, Less less = Less())
+        : k(runs.size()), heads(runs.size()), ends(runs.size()), tree(runs.size() > 0 ? runs.size() : 1), less(less) {
+
+        for (size_t i = 0; i < k; ++i) {
+            heads[i] = runs[i].b;
+            ends[i] = runs[i].e;
+        }
+        if (k > 0) tree[0] = build(1);
+    }
+
+    bool empty() const { return k == 0 || tree[0].done; }
+
+    const T& top() const { return tree[0].key; }
+
+    size_t top_run() const { return tree[0].run; }
+
+    void pop() {
+        Node winner = tree[0];
+        load(winner, ++heads[winner.run]);
+
+        for (size_t node = (k + winner.run) / 2; node >= 1; node /= 2) {
+            Node loser = tree[node];
+            bool swap = beats(loser, winner);
+            tree[node] = swap ? winner : loser;
+            winner = swap ? loser : winner;
+        }
+        tree[0] = winner;
+    }
+
+private:
+    struct Node {
+        T key{};
+        size_t run = 0;
+        bool done = true;
+    };
+
+    void load(Node& node, const T* head) const {
+        node.done = head == ends[node.run];
+        if (!node.done) node.key = *head;
+    }
+
+    bool beats(const Node& a, const Node& b) const {
+        bool lt = less(a.key, b.key);
+        bool gt = less(b.key, a.key);
+        bool key_first = a.done | b.done ? false : lt | (!gt & (a.run < b.run));
+        bool done_first = a.done == b.done ? a.done & (a.run < b.run) : b.done;
+        return key_first | done_first;
     }
 
+    Node build(size_t node) {
+        if (node >= k) {
+            Node leaf;
+            leaf.run = node - k;
+            load(leaf, heads[leaf.run]);
+            return leaf;
+        }
+
+        Node l = build(2 * node);
+        Node r = build(2 * node + 1);
+
+        if (beats(r, l)) {
+            tree[node] = l;
+            return r;
+        }
+        tree[node] = r;
+        return l;
+    }
+
+    size_t k;
+    std::vector<const T*> heads;
+    std::vector<const T*> ends;
+    std::vector<Node> tree;
+    Less less;
+};
+
+
+template <typename T>
+std::make_unsigned_t<T> to_ordered_bits(T value) {
+    using U = std::make_unsigned_t<T>;
+    constexpr U sign = std::is_signed_v<T> ? U(U(1) << (8 * sizeof(T) - 1)) : U(0);
+    return U(U(value) ^ sign);
+}
+
+
+template <typename T>
+T from_ordered_bits(std::make_unsigned_t<T> bits) {
+    using U = std::make_unsigned_t<T>;
+    constexpr U sign = std::is_signed_v<T> ? U(U(1) << (8 * sizeof(T) - 1)) : U(0);
+    return T(U(bits ^ sign));
+}
+
+
+template <typename T>
+class PackedLoserTree {
+public:
+    explicit PackedLoserTree(const std::vector<SortedRun<T>>& runs)
+        : k(runs.size()), heads(runs.size()), ends(runs.size()), tree(runs.size() > 0 ? runs.size() : 1, DONE) {
+
+        for (size_t i = 0; i < k; ++i) {
+            heads[i] = runs[i].b;
+            ends[i] = runs[i].e;
+        }
+
+        std::vector<uint64_t> winners(2 * k);
+        for (size_t i = 0; i < k; ++i) winners[k + i] = pack(i);
+        for (size_t node = k - 1; node >= 1 && node < k; --node) {
+            winners[node] = std::min(winners[2 * node], winners[2 * node + 1]);
+            tree[node] = std::max(winners[2 * node], winners[2 * node + 1]);
+        }
+        if (k > 0) tree[0] = k > 1 ? winners[1] : winners[k];
+    }
+
+    bool empty() const { return tree[0] >= DONE; }
+
+    T top() const { return unpack_key(tree[0]); }
+
+    size_t top_run() const { return size_t(tree[0] & RUN_MASK); }
+
+    void pop() {
+        size_t run = top_run();
+        ++heads[run];
+        uint64_t winner = pack(run);
+
+        for (size_t node = (k + run) / 2; node >= 1; node /= 2) {
+            uint64_t loser = tree[node];
+            tree[node] = std::max(loser, winner);
+            winner = std::min(loser, winner);
+        }
+        tree[0] = winner;
+    }
+
+private:
+    static constexpr uint64_t RUN_MASK = (uint64_t(1) << 31) - 1;
+    static constexpr uint64_t DONE = uint64_t(1) << 63;
+
+    uint64_t pack(size_t run) const {
+        if (heads[run] == ends[run]) return DONE | run;
+        uint64_t key = to_ordered_bits(*heads[run]);
+        return (key << 31) | run;
+    }
+
+    static T unpack_key(uint64_t packed) {
+        return from_ordered_bits<T>(std::make_unsigned_t<T>(packed >> 31));
+    }
+
+    size_t k;
+    std::vector<const T*> heads;
+    std::vector<const T*> ends;
+    std::vector<uint64_t> tree;
+};
+
+
+template <typename T, typename Less>
+constexpr bool packed_loser_tree_fits = std::is_integral_v<T> && sizeof(T) <= 4 && is_natural_less<Less, T>;
+
+
+template <typename T, typename Less = std::less<T>>
+T* kway_merge(const std::vector<SortedRun<T>>& runs, T* out, Less less = Less()) {
+
+    if (runs.size() == 1) return std::copy(runs[0].b, runs[0].e, out);
+    if (runs.size() == 2) return merge_leaf(runs[0].b, runs[0].e, runs[1].b, runs[1].e, out, less);
+
+    auto drain = [&out](auto& tree) {
+        while (!tree.empty()) {
+            *out++ = tree.top();
+            tree.pop();
+        }
+    };
+
+    if constexpr (packed_loser_tree_fits<T, Less>) {
+        PackedLoserTree<T> tree(runs);
+        drain(tree);
+    }
+    else {
+        LoserTree<T, Less> tree(runs, less);
+        drain(tree);
+    }
+    return out;
+}
+
+
+template <typename T, typename Less = std::less<T>>
+std::vector<size_t> multisequence_select(const std::vector<SortedRun<T>>& runs, size_t rank, Less less = Less()) {
+
+    size_t k = runs.size();
+    std::vector<size_t> lo(k, 0), hi(k), lb(k), ub(k);
+    for (size_t i = 0; i < k; ++i) hi[i] = runs[i].size();
+
+    while (true) {
+        size_t pick = k;
+        size_t widest = 0;
+        for (size_t i = 0; i < k; ++i) {
+            if (hi[i] - lo[i] > widest) {
+                widest = hi[i] - lo[i];
+                pick = i;
+            }
+        }
+        if (pick == k) return lo;
+
+        const T& pivot = runs[pick].b[lo[pick] + widest / 2];
+
+        size_t below = 0, not_above = 0;
+        for (size_t i = 0; i < k; ++i) {
+            lb[i] = std::lower_bound(runs[i].b, runs[i].e, pivot, less) - runs[i].b;
+            ub[i] = std::upper_bound(runs[i].b + lb[i], runs[i].e, pivot, less) - runs[i].b;
+            below += lb[i];
+            not_above += ub[i];
+        }
+
+        if (rank < below) {
+            for (size_t i = 0; i < k; ++i) hi[i] = std::min(hi[i], lb[i]);
+        }
+        else if (rank > not_above) {
+            for (size_t i = 0; i < k; ++i) lo[i] = std::max(lo[i], ub[i]);
+        }
+        else {
+            size_t need = rank - below;
+            for (size_t i = 0; i < k; ++i) {
+                size_t take = std::min(need, ub[i] - lb[i]);
+                lb[i] += take;
+                need -= take;
+            }
+            return lb;
+        }
+    }
+}
+
+
+template <typename T, typename Less = std::less<T>>
+void parallel_kway_merge(ThreadPool& pool, const std::vector<SortedRun<T>>& runs, T* out, size_t parts, Less less = Less()) {
+
+    size_t total = 0;
+    for (const auto& r : runs) total += r.size();
+
+    if (parts <= 1 || total == 0) {
+        kway_merge(runs, out, less);
+        return;
+    }
+
+    pool.run_tasks(parts, [&](size_t p) {
+        size_t r_b = total * p / parts;
+        size_t r_e = total * (p + 1) / parts;
+
+        auto split_b = multisequence_select(runs, r_b, less);
+        auto split_e = multisequence_select(runs, r_e, less);
+
+        std::vector<SortedRun<T>> slice;
+        slice.reserve(runs.size());
+        for (size_t i = 0; i < runs.size(); ++i) {
+            if (split_b[i] < split_e[i])
+                slice.push_back({ runs[i].b + split_b[i], runs[i].b + split_e[i] });
+        }
+
+        kway_merge(slice, out + r_b, less);
+        });
+}
+
+
+template <typename T>
+std::vector<T> fold_merge_runs(const std::vector<SortedRun<T>>& runs) {
+
+    std::vector<T> merged(runs[0].b, runs[0].e);
+
+    for (size_t i = 1; i < runs.size(); ++i) {
+        std::vector<T> tmp(merged.size() + runs[i].size());
+        merge_leaf(merged.begin(), merged.end(), runs[i].b, runs[i].e, tmp.begin());
+        merged.swap(tmp);
+    }
+    return merged;
+}
+
+
+void run_kway_merge_benchmarks(ThreadPool& pool, std::ostream& out, size_t n) {
+
+    size_t total = 2 * n;
+
+    for (size_t R : { 4, 16, 64, 256 }) {
+
+        out << "=== K-way Merge, runs=" << R << ", total N=" << total << " ===\n";
+
+        std::vector<std::vector<int>> data(R);
+        std::vector<SortedRun<int>> runs;
+        for (size_t i = 0; i < R; ++i) {
+            data[i] = generate_sorted_vector(total * (i + 1) / R - total * i / R);
+            runs.push_back({ data[i].data(), data[i].data() + data[i].size() });
+        }
+
+        std::vector<int> expected;
+        std::string tag = "/runs=" + std::to_string(R) + "/N=" + std::to_string(total);
+
+        auto fold = bench::run("kway/pairwise_fold" + tag, [&]() {
+            expected = fold_merge_runs(runs);
+            });
+        out << "pairwise fold:       " << fold << "\n";
+
+        std::vector<int> C(total);
+
+        auto seq = bench::run("kway/loser_tree" + tag, [&]() {
+            kway_merge(runs, C.data());
+            });
+        out << "loser tree:          " << seq << (C == expected ? "" : ", MISMATCH") << "\n";
+
+        size_t parts = pool.concurrency();
+        auto par = bench::run("kway/parallel_loser_tree/P=" + std::to_string(parts) + tag, [&]() {
+            parallel_kway_merge(pool, runs, C.data(), parts);
+            });
+        out << "parallel loser tree: " << par << ", P=" << parts
+            << (C == expected ? "" : ", MISMATCH") << "\n";
+
+        out << "speedup vs fold: sequential = " << fold.median / seq.median
+            << ", parallel = " << fold.median / par.median << "\n\n";
+    }
+}
+
+template <typename Key, size_t PayloadBytes>
+struct Record {
+    Key key;
+    std::array<unsigned char, PayloadBytes> payload;
+};
+
+
+struct ByKey {
+    template <typename R>
+    auto operator()(const R& r) const -> decltype(r.key) { return r.key; }
+};
+
+
+template <typename KeyOf, typename KeyLess = std::less<>>
+struct CompareByKey {
+    KeyOf key_of;
+    KeyLess key_less;
+
+    template <typename R>
+    bool operator()(const R& a, const R& b) const { return key_less(key_of(a), key_of(b)); }
+};
+
+
+template <typename Key, typename KeyLess, typename = void>
+struct KeyIndexCodec {
+    struct Entry {
+        Key key;
+        uint32_t index;
+    };
+
+    struct Less {
+        KeyLess key_less;
+        bool operator()(const Entry& x, const Entry& y) const { return key_less(x.key, y.key); }
+    };
+
+    static Entry make(const Key& key, uint32_t index) { return { key, index }; }
+
+    static uint32_t index(const Entry& e) { return e.index; }
+
+    static Less less(KeyLess key_less) { return { key_less }; }
+};
+
+
+template <typename Key, typename KeyLess>
+struct KeyIndexCodec<Key, KeyLess, std::enable_if_t<std::is_integral_v<Key> && sizeof(Key) <= 4 && is_natural_less<KeyLess, Key>>> {
+    using Entry = uint64_t;
+    using Less = std::less<uint64_t>;
+
+    static Entry make(Key key, uint32_t index) { return (uint64_t(to_ordered_bits(key)) << 32) | index; }
+
+    static uint32_t index(Entry e) { return uint32_t(e); }
+
+    static Less less(KeyLess) { return {}; }
+};
+
+
+template <typename Rec, typename KeyOf = ByKey, typename KeyLess = std::less<>>
+void merge_records(ThreadPool& pool, const Rec* a, size_t n_a, const Rec* b, size_t n_b, Rec* out,
+    size_t K, KeyOf key_of = KeyOf(), KeyLess key_less = KeyLess()) {
+
+    static_assert(std::is_trivially_copyable_v<Rec>, "merge_records needs trivially copyable records");
+
+    merge_path_parallel_merge(pool, a, a + n_a, b, b + n_b, out, K, CompareByKey<KeyOf, KeyLess>{ key_of, key_less });
+}
+
+
+template <typename Rec, typename KeyOf = ByKey, typename KeyLess = std::less<>>
+void merge_records_key_index(ThreadPool& pool, const Rec* a, size_t n_a, const Rec* b, size_t n_b, Rec* out,
+    size_t K, KeyOf key_of = KeyOf(), KeyLess key_less = KeyLess()) {
+
+    static_assert(std::is_trivially_copyable_v<Rec>, "merge_records_key_index needs trivially copyable records");
+
+    size_t total = n_a + n_b;
+    if (total > UINT32_MAX) {
+        merge_records(pool, a, n_a, b, n_b, out, K, key_of, key_less);
+        return;
+    }
+
+    using Key = std::decay_t<decltype(key_of(*a))>;
+    using Codec = KeyIndexCodec<Key, KeyLess>;
+    using Entry = typename Codec::Entry;
+
+    // звичайні локальні змінні: задачі пулу нижче захоплюють їх за посиланням,
+    // а з thread_local кожен робочий потік отримав би власну порожню копію
+    std::vector<Entry> keys(total);
+    std::vector<Entry> merged(total);
+
+    size_t parts = std::max<size_t>(K, 1);
+
+    pool.run_tasks(parts, [&](size_t p) {
+        for (size_t i = total * p / parts; i < total * (p + 1) / parts; ++i)
+            keys[i] = Codec::make(i < n_a ? key_of(a[i]) : key_of(b[i - n_a]), uint32_t(i));
+        });
+
+    merge_path_parallel_merge(pool, keys.data(), keys.data() + n_a, keys.data() + n_a, keys.data() + total,
+        merged.data(), K, Codec::less(key_less));
+
+    pool.run_tasks(parts, [&](size_t p) {
+        for (size_t i = total * p / parts; i < total * (p + 1) / parts; ++i) {
+            uint32_t src = Codec::index(merged[i]);
+            out[i] = src < n_a ? a[src] : b[src - n_a];
+        }
+        });
+}
+
+
+template <typename Rec>
+std::vector<Rec> generate_sorted_records(size_t n) {
+
+    std::mt19937_64 rng(std::random_device{}());
+
+    std::vector<Rec> v(n);
+    for (auto& r : v) {
+        r.key = static_cast<decltype(r.key)>(rng() % 1'000'000);
+        for (auto& byte : r.payload) byte = static_cast<unsigned char>(rng());
+    }
+    std::sort(v.begin(), v.end(), CompareByKey<ByKey>{});
+    return v;
+}
+
+
+// злиття за індексом ключів проти std::merge на пулі, де справді є робочі потоки
+// (у спільному пулі на одноядерних машинах їх немає)
+template <typename Rec>
+bool check_key_index_merge(ThreadPool& pool, size_t n) {
+
+    auto A = generate_sorted_records<Rec>(n);
+    auto B = generate_sorted_records<Rec>(n + 17);
+    std::vector<Rec> expected(A.size() + B.size()), got(A.size() + B.size());
+
+    std::merge(A.begin(), A.end(), B.begin(), B.end(), expected.begin(), CompareByKey<ByKey>{});
+    merge_records_key_index(pool, A.data(), A.size(), B.data(), B.size(), got.data(), 2 * pool.concurrency());
+
+    return std::memcmp(expected.data(), got.data(), expected.size() * sizeof(Rec)) == 0;
+}
+
+
+template <typename Rec>
+void benchmark_record_merge(ThreadPool& pool, std::ostream& out, size_t n, const std::string& label) {
+
+    auto A = generate_sorted_records<Rec>(n);
+    auto B = generate_sorted_records<Rec>(n);
+    std::vector<Rec> direct(2 * n), indexed(2 * n);
+
+    size_t K = pool.concurrency();
+    std::string tag = "/" + label + "/N=" + std::to_string(n);
+
+    auto d = bench::run("records/direct" + tag, [&]() {
+        merge_records(pool, A.data(), A.size(), B.data(), B.size(), direct.data(), K);
+        });
+
+    auto k = bench::run("records/key_index" + tag, [&]() {
+        merge_records_key_index(pool, A.data(), A.size(), B.data(), B.size(), indexed.data(), K);
+        });
+
+    bool ok = std::memcmp(direct.data(), indexed.data(), direct.size() * sizeof(Rec)) == 0;
+
+    double bytes = double(2 * n) * sizeof(Rec);
+    out << label << " (" << sizeof(Rec) << " B/record)\n"
+        << "  direct:    " << d << ", GBps=" << bytes / d.median / 1e6 << "\n"
+        << "  key-index: " << k << ", GBps=" << bytes / k.median / 1e6
+        << (ok ? "" : ", MISMATCH") << "\n";
+}
+
+
+void run_record_merge_benchmarks(ThreadPool& pool, std::ostream& out, size_t n) {
+
+    out << "=== Typed record merge, N=" << n << " per input ===\n";
+
+    ThreadPool check_pool(3);
+    bool checked = check_key_index_merge<Record<uint32_t, 12>>(check_pool, 10007)
+        && check_key_index_merge<Record<uint64_t, 16>>(check_pool, 10007);
+    out << "key-index check (" << check_pool.size() << " workers): " << (checked ? "ok" : "MISMATCH") << "\n";
+
+    benchmark_record_merge<Record<uint32_t, 12>>(pool, out, n, "u32 key + 12 B");
+    benchmark_record_merge<Record<uint64_t, 8>>(pool, out, n, "u64 key + 8 B");
+    benchmark_record_merge<Record<uint64_t, 16>>(pool, out, n, "u64 key + 16 B");
+    benchmark_record_merge<Record<uint32_t, 60>>(pool, out, n, "u32 key + 60 B");
+    benchmark_record_merge<Record<uint64_t, 248>>(pool, out, n, "u64 key + 248 B");
+
+    out << "\n";
+}
+
+
+size_t os_page_size() {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return size_t(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) return;
+        bytes = size_t(size.QuadPart);
+        if (bytes == 0) {
+            opened = true;
+            return;
+        }
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return;
+
+        base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        opened = base != nullptr;
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) return;
+        bytes = size_t(st.st_size);
+        if (bytes == 0) {
+            opened = true;
+            return;
+        }
+
+        void* p = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return;
+
+        base = static_cast<const char*>(p);
+        madvise(p, bytes, MADV_SEQUENTIAL);
+        opened = true;
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(_WIN32)
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (base) munmap(const_cast<char*>(base), bytes);
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return opened; }
+
+    size_t size() const { return bytes; }
+
+    template <typename T>
+    SortedRun<T> as_run() const {
+        const T* p = reinterpret_cast<const T*>(base);
+        return { p, p + bytes / sizeof(T) };
+    }
+
+    void will_need(size_t offset, size_t length) const { advise(offset, length, true); }
+
+    void dont_need(size_t offset, size_t length) const { advise(offset, length, false); }
+
+private:
+    void advise(size_t offset, size_t length, bool need) const {
+#if defined(_WIN32)
+        (void)offset;
+        (void)length;
+        (void)need;
+#else
+        if (!base || offset >= bytes) return;
+
+        size_t page = os_page_size();
+        size_t b = offset / page * page;
+        size_t e = std::min(bytes, offset + length);
+        if (e <= b) return;
+
+        madvise(const_cast<char*>(base) + b, e - b, need ? MADV_WILLNEED : MADV_DONTNEED);
+#endif
+    }
+
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    const char* base = nullptr;
+    size_t bytes = 0;
+    bool opened = false;
+};
+
+
+class AlignedBuffer {
+public:
+    static constexpr size_t ALIGNMENT = 4096;
+
+    explicit AlignedBuffer(size_t bytes)
+        : p(static_cast<char*>(::operator new(bytes, std::align_val_t(ALIGNMENT)))), bytes(bytes) {}
+
+    ~AlignedBuffer() { ::operator delete(p, std::align_val_t(ALIGNMENT)); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    char* data() { return p; }
+
+    size_t size() const { return bytes; }
+
+private:
+    char* p;
+    size_t bytes;
+};
+
+
+class AlignedFileWriter {
+public:
+    AlignedFileWriter(const std::string& path, bool direct_io) {
+#if defined(_WIN32)
+        DWORD flags = FILE_FLAG_SEQUENTIAL_SCAN;
+        file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, flags, nullptr);
+        (void)direct_io;
+#else
+#ifdef O_DIRECT
+        if (direct_io) {
+            fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+            direct = direct_opened = fd >= 0;
+        }
+#else
+        (void)direct_io;
+#endif
+        if (fd < 0) fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    }
+
+    ~AlignedFileWriter() {
+#if defined(_WIN32)
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    AlignedFileWriter(const AlignedFileWriter&) = delete;
+    AlignedFileWriter& operator=(const AlignedFileWriter&) = delete;
+
+    bool is_open() const {
+#if defined(_WIN32)
+        return file != INVALID_HANDLE_VALUE;
+#else
+        return fd >= 0;
+#endif
+    }
+
+    bool uses_direct_io() const { return direct_opened; }
+
+    bool write(const char* data, size_t bytes) {
+#if defined(_WIN32)
+        while (bytes > 0) {
+            DWORD chunk = DWORD(std::min<size_t>(bytes, 1u << 30));
+            DWORD written = 0;
+            if (!WriteFile(file, data, chunk, &written, nullptr) || written == 0) return false;
+            data += written;
+            bytes -= written;
+        }
+        return true;
+#else
+#ifdef O_DIRECT
+        if (direct && bytes % AlignedBuffer::ALIGNMENT != 0) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+            direct = false;
+        }
+#endif
+        while (bytes > 0) {
+            ssize_t written = ::write(fd, data, bytes);
+            if (written <= 0) return false;
+            data += written;
+            bytes -= size_t(written);
+        }
+        return true;
+#endif
+    }
+
+private:
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+#else
+    int fd = -1;
+#endif
+    bool direct = false;
+    bool direct_opened = false;
+};
+
+
+bool write_sorted_file(const std::string& path, size_t n) {
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    std::mt19937 rng(std::random_device{}());
+    int step = int(std::max<size_t>(1, 2'000'000'000 / std::max<size_t>(n, 1)));
+    std::uniform_int_distribution<int> dist(0, step);
+
+    std::vector<int> chunk(1 << 20);
+    long long value = 0;
+
+    for (size_t done = 0; done < n; ) {
+        size_t count = std::min(chunk.size(), n - done);
+        for (size_t i = 0; i < count; ++i) {
+            value += dist(rng);
+            chunk[i] = int(value);
+        }
+        file.write(reinterpret_cast<const char*>(chunk.data()), std::streamsize(count * sizeof(int)));
+        done += count;
+    }
+    return bool(file);
+}
+
+
+// Один довгоживучий потік запису для подвійної буферизації виводу, щоб у виміряному циклі
+// не створювати потік на кожен блок: submit() передає блок, wait() чекає, доки попередній
+// блок буде записано, і повертає результат запису.
+class BackgroundWriter {
+public:
+    explicit BackgroundWriter(AlignedFileWriter& writer) : writer(writer), thread([this]() { loop(); }) {}
+
+    ~BackgroundWriter() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stopping = true;
+        }
+        cv.notify_all();
+        thread.join();
+    }
+
+    BackgroundWriter(const BackgroundWriter&) = delete;
+    BackgroundWriter& operator=(const BackgroundWriter&) = delete;
+
+    void submit(const char* data, size_t bytes) {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            job_data = data;
+            job_bytes = bytes;
+            has_job = true;
+        }
+        cv.notify_all();
+    }
+
+    bool wait() {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&]() { return !has_job; });
+        return last_ok;
+    }
+
+private:
+    void loop() {
+        std::unique_lock<std::mutex> lock(m);
+        while (true) {
+            cv.wait(lock, [&]() { return has_job || stopping; });
+            if (!has_job) return;
+
+            lock.unlock();
+            bool ok = writer.write(job_data, job_bytes);
+            lock.lock();
+
+            last_ok = ok;
+            has_job = false;
+            cv.notify_all();
+        }
+    }
+
+    AlignedFileWriter& writer;
+    std::mutex m;
+    std::condition_variable cv;
+    const char* job_data = nullptr;
+    size_t job_bytes = 0;
+    bool has_job = false;
+    bool last_ok = true;
+    bool stopping = false;
+    std::thread thread;
+};
+
+
+struct StreamMergeResult {
+    bool ok = false;
+    bool direct_io = false;
+    size_t elements = 0;
+    double seconds = 0;
+};
+
+
+StreamMergeResult stream_merge_files(ThreadPool& pool, const std::vector<std::string>& inputs,
+    const std::string& output, size_t block_bytes, bool direct_io) {
+
+    StreamMergeResult result;
+
+    std::vector<std::unique_ptr<MappedFile>> files;
+    std::vector<SortedRun<int>> runs;
+    for (const auto& path : inputs) {
+        files.push_back(std::make_unique<MappedFile>(path));
+        if (!files.back()->is_open()) return result;
+        runs.push_back(files.back()->as_run<int>());
+    }
+
+    size_t total = 0;
+    for (const auto& r : runs) total += r.size();
+
+    AlignedFileWriter writer(output, direct_io);
+    if (!writer.is_open()) return result;
+
+    size_t block = std::max<size_t>(1, block_bytes / sizeof(int) / 1024) * 1024;
+    AlignedBuffer buffers[2] = { AlignedBuffer(block * sizeof(int)), AlignedBuffer(block * sizeof(int)) };
+    size_t parts = pool.concurrency();
+
+    BackgroundWriter background(writer);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<size_t> split_b(runs.size(), 0), split_e;
+    bool ok = true;
+    int cur = 0;
+
+    for (size_t d_b = 0; d_b < total && ok; d_b += block) {
+        size_t d_e = std::min(total, d_b + block);
+        int* buf = reinterpret_cast<int*>(buffers[cur].data());
+
+        if (runs.size() == 2) {
+            const SortedRun<int>& a = runs[0];
+            const SortedRun<int>& b = runs[1];
+            size_t a_e = merge_path_co_rank(d_e, a.b, a.size(), b.b, b.size());
+            split_e = { a_e, d_e - a_e };
+
+            merge_path_parallel_merge(pool, a.b + split_b[0], a.b + split_e[0],
+                b.b + split_b[1], b.b + split_e[1], buf, parts);
+        }
+        else {
+            split_e = multisequence_select(runs, d_e);
+
+            std::vector<SortedRun<int>> slices;
+            for (size_t i = 0; i < runs.size(); ++i) {
+                if (split_b[i] < split_e[i])
+                    slices.push_back({ runs[i].b + split_b[i], runs[i].b + split_e[i] });
+            }
+            parallel_kway_merge(pool, slices, buf, parts);
+        }
+
+        for (size_t i = 0; i < runs.size(); ++i) {
+            files[i]->dont_need(split_b[i] * sizeof(int), (split_e[i] - split_b[i]) * sizeof(int));
+            files[i]->will_need(split_e[i] * sizeof(int), block * sizeof(int));
+        }
+        split_b = split_e;
+
+        if (!background.wait()) {
+            ok = false;
+            break;
+        }
+        background.submit(reinterpret_cast<const char*>(buf), (d_e - d_b) * sizeof(int));
+        cur ^= 1;
+    }
+
+    ok = background.wait() && ok;
+
+    auto end = std::chrono::steady_clock::now();
+
+    result.ok = ok;
+    result.direct_io = writer.uses_direct_io();
+    result.elements = total;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    return result;
+}
+
+
+bool verify_sorted_file(const std::string& path, size_t expected_elements) {
+    MappedFile file(path);
+    if (!file.is_open()) return false;
+
+    auto run = file.as_run<int>();
+    return run.size() == expected_elements && std::is_sorted(run.b, run.e);
+}
+
+
+void run_streaming_merge_benchmarks(ThreadPool& pool, std::ostream& out, size_t n_per_file, size_t block_bytes) {
+
+    for (size_t files : { 2, 4 }) {
+
+        out << "=== Streaming mmap merge, files=" << files << ", N per file=" << n_per_file
+            << ", block=" << block_bytes / (1 << 20) << " MiB ===\n";
+
+        std::vector<std::string> inputs;
+        bool generated = true;
+        for (size_t i = 0; i < files; ++i) {
+            inputs.push_back("stream_in_" + std::to_string(i) + ".bin");
+            generated = write_sorted_file(inputs.back(), n_per_file) && generated;
+        }
+
+        if (!generated) {
+            out << "cannot write input files\n\n";
+            continue;
+        }
+
+        for (bool direct : { false, true }) {
+            std::string output = "stream_out.bin";
+            auto r = stream_merge_files(pool, inputs, output, block_bytes, direct);
+            bool sorted = r.ok && verify_sorted_file(output, files * n_per_file);
+
+            double bytes = double(r.elements) * sizeof(int);
+            out << (direct ? "O_DIRECT requested" : "buffered          ")
+                << ": time_s=" << r.seconds
+                << ", out_GBps=" << bytes / r.seconds / 1e9
+                << ", in+out_GBps=" << 2 * bytes / r.seconds / 1e9
+                << (r.direct_io || !direct ? "" : " (fell back to buffered)")
+                << (sorted ? "" : ", FAILED") << "\n";
+
+            std::remove(output.c_str());
+        }
+
+        for (const auto& path : inputs) std::remove(path.c_str());
+        out << "\n";
+    }
+}
+
+struct CpuTopology {
+    size_t l2_bytes = size_t(1) << 20;
+    size_t nodes = 1;
+    std::vector<int> cpu_node;      // щільний номер вузла в [0, nodes)
+    std::vector<int> node_ids{ 0 }; // справжній номер вузла в системі для кожного щільного
+};
+
+
+CpuTopology detect_cpu_topology() {
+
+    CpuTopology topo;
+    size_t hw = std::max<size_t>(1, std::thread::hardware_concurrency());
+    topo.cpu_node.assign(hw, 0);
+
+#if defined(_WIN32)
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!info.empty() && GetLogicalProcessorInformation(info.data(), &length)) {
+        for (const auto& entry : info) {
+            if (entry.Relationship == RelationCache && entry.Cache.Level == 2 && entry.Cache.Type != CacheInstruction) {
+                topo.l2_bytes = entry.Cache.Size;
+                break;
+            }
+        }
+    }
+
+    for (size_t cpu = 0; cpu < hw && cpu < 64; ++cpu) {
+        UCHAR node = 0;
+        if (GetNumaProcessorNode(UCHAR(cpu), &node) && node != 0xFF) topo.cpu_node[cpu] = node;
+    }
+#elif defined(__linux__)
+    // indexN не прив'язані до рівнів: шукаємо кеш рівня 2, що не є кешем інструкцій
+    for (int index = 0; index < 16; ++index) {
+        std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::ifstream level_file(dir + "level");
+        if (!level_file.is_open()) break;
+
+        int level = 0;
+        std::string type;
+        std::ifstream type_file(dir + "type");
+        if (!(level_file >> level) || level != 2 || !(type_file >> type) || type == "Instruction") continue;
+
+        std::ifstream size_file(dir + "size");
+        size_t value = 0;
+        char unit = 0;
+        if (size_file >> value) {
+            size_file >> unit;
+            topo.l2_bytes = value * (unit == 'K' ? 1024 : unit == 'M' ? 1024 * 1024 : 1);
+        }
+        break;
+    }
+
+    for (int node = 0; node < 64; ++node) {
+        std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!cpulist.is_open()) continue;
+
+        // у вузлів лише з пам'яттю cpulist порожній; порожні й некоректні діапазони пропускаються
+        std::string range;
+        while (std::getline(cpulist, range, ',')) {
+            const char* p = range.data();
+            const char* end = p + range.size();
+            while (p != end && std::isspace(static_cast<unsigned char>(*p))) ++p;
+
+            int first = 0;
+            auto parsed = std::from_chars(p, end, first);
+            if (parsed.ec != std::errc()) continue;
+
+            int last = first;
+            if (parsed.ptr != end && *parsed.ptr == '-' &&
+                std::from_chars(parsed.ptr + 1, end, last).ec != std::errc()) continue;
+
+            for (int cpu = std::max(first, 0); cpu <= last && size_t(cpu) < hw; ++cpu) topo.cpu_node[cpu] = node;
+        }
+    }
+#endif
+
+    // номери вузлів можуть іти з пропусками: у таблицю потрапляють лише ті, де є процесори
+    topo.node_ids.assign(topo.cpu_node.begin(), topo.cpu_node.end());
+    std::sort(topo.node_ids.begin(), topo.node_ids.end());
+    topo.node_ids.erase(std::unique(topo.node_ids.begin(), topo.node_ids.end()), topo.node_ids.end());
+    for (int& node : topo.cpu_node) {
+        node = int(std::lower_bound(topo.node_ids.begin(), topo.node_ids.end(), node) - topo.node_ids.begin());
+    }
+    topo.nodes = topo.node_ids.size();
+    return topo;
+}
+
+
+enum class Placement { none, compact, scatter };
+
+
+const char* placement_name(Placement p) {
+    switch (p) {
+    case Placement::compact: return "compact";
+    case Placement::scatter: return "scatter";
+    default: return "none";
+    }
+}
+
+
+std::vector<int> place_workers(const CpuTopology& topo, size_t workers, Placement policy) {
+
+    std::vector<int> cpus(workers, -1);
+    if (policy == Placement::none) return cpus;
+
+    std::vector<std::vector<int>> by_node(topo.nodes);
+    for (size_t cpu = 0; cpu < topo.cpu_node.size(); ++cpu) by_node[topo.cpu_node[cpu]].push_back(int(cpu));
+
+    std::vector<int> order;
+    if (policy == Placement::compact) {
+        for (const auto& node : by_node) order.insert(order.end(), node.begin(), node.end());
+    }
+    else {
+        for (size_t i = 0; order.size() < topo.cpu_node.size(); ++i) {
+            for (const auto& node : by_node) {
+                if (i < node.size()) order.push_back(node[i]);
+            }
+        }
+    }
+
+    for (size_t w = 0; w < workers; ++w) cpus[w] = order[w % order.size()];
+    return cpus;
+}
+
+
+struct NumaMergeStats {
+    std::vector<double> node_bytes;
+    std::vector<size_t> node_workers;
+};
+
+
+void numa_aware_parallel_merge(ThreadPool& pool, const CpuTopology& topo, const std::vector<int>& worker_cpu,
+    const int* a, size_t n_a, const int* b, size_t n_b, int* out, NumaMergeStats* stats = nullptr) {
+
+    size_t total = n_a + n_b;
+    size_t workers = std::max<size_t>(1, pool.size());
+
+    size_t block = std::max<size_t>(1024, topo.l2_bytes / 2 / sizeof(int));
+    size_t blocks = (total + block - 1) / block;
+
+    if (stats) {
+        stats->node_bytes.assign(topo.nodes, 0);
+        stats->node_workers.assign(topo.nodes, 0);
+    }
+    std::vector<double> worker_bytes(workers, 0);
+
+    pool.run_on_workers([&](size_t w) {
+        size_t d_b = std::min(total, blocks * w / workers * block);
+        size_t d_e = std::min(total, blocks * (w + 1) / workers * block);
+
+        size_t a_b = merge_path_co_rank(d_b, a, n_a, b, n_b);
+        for (size_t d = d_b; d < d_e; d += block) {
+            size_t next = std::min(d_e, d + block);
+            size_t a_e = merge_path_co_rank(next, a, n_a, b, n_b);
+
+            merge_leaf(a + a_b, a + a_e, b + (d - a_b), b + (next - a_e), out + d);
+            a_b = a_e;
+        }
+        worker_bytes[w] = double(d_e - d_b) * sizeof(int) * 2;
+        });
+
+    if (stats) {
+        for (size_t w = 0; w < workers; ++w) {
+            int cpu = w < worker_cpu.size() ? worker_cpu[w] : -1;
+            size_t node = cpu >= 0 ? size_t(topo.cpu_node[cpu]) : 0;
+            stats->node_bytes[node] += worker_bytes[w];
+            stats->node_workers[node] += 1;
+        }
+    }
+}
+
+
+void first_touch_output(ThreadPool& pool, const CpuTopology& topo, int* out, size_t total) {
+
+    size_t workers = std::max<size_t>(1, pool.size());
+    size_t block = std::max<size_t>(1024, topo.l2_bytes / 2 / sizeof(int));
+    size_t blocks = (total + block - 1) / block;
+
+    pool.run_on_workers([&](size_t w) {
+        size_t d_b = std::min(total, blocks * w / workers * block);
+        size_t d_e = std::min(total, blocks * (w + 1) / workers * block);
+        std::fill(out + d_b, out + d_e, 0);
+        });
+}
+
+
+void run_numa_merge_benchmarks(ThreadPool& pool, std::ostream& out, size_t n) {
+
+    CpuTopology topo = detect_cpu_topology();
+
+    out << "=== NUMA / cache-aware merge, N=" << n
+        << ", L2=" << topo.l2_bytes / 1024 << " KiB"
+        << ", nodes=" << topo.nodes
+        << ", workers=" << std::max<size_t>(1, pool.size()) << " ===\n";
+
+    auto A = generate_sorted_vector(n);
+    auto B = generate_sorted_vector(n);
+    size_t total = A.size() + B.size();
+
+    std::vector<int> expected(total);
+    std::merge(A.begin(), A.end(), B.begin(), B.end(), expected.begin());
+
+    std::vector<int> C(total);
+    auto base = bench::run("numa/equal_chunks/N=" + std::to_string(n), [&]() {
+        merge_path_parallel_merge(pool, A.begin(), A.end(), B.begin(), B.end(), C.begin(), pool.concurrency());
+        });
+    out << "equal chunks (merge path): " << base << "\n";
+
+    for (Placement policy : { Placement::none, Placement::compact, Placement::scatter }) {
+
+        std::vector<int> cpus = place_workers(topo, pool.size(), policy);
+        for (size_t w = 0; w < pool.size(); ++w) {
+            if (cpus[w] >= 0) pool.pin_worker(w, cpus[w]);
+            else pool.unpin_worker(w);
+        }
+
+        AlignedBuffer buffer(total * sizeof(int));
+        int* D = reinterpret_cast<int*>(buffer.data());
+        first_touch_output(pool, topo, D, total);
+
+        NumaMergeStats stats;
+        auto r = bench::run(std::string("numa/l2_blocks/") + placement_name(policy) + "/N=" + std::to_string(n), [&]() {
+            numa_aware_parallel_merge(pool, topo, cpus, A.data(), A.size(), B.data(), B.size(), D, &stats);
+            });
+
+        bool ok = std::equal(expected.begin(), expected.end(), D);
+
+        out << "L2 blocks, placement=" << placement_name(policy) << ": " << r
+            << (ok ? "" : ", MISMATCH") << "\n";
+        for (size_t node = 0; node < topo.nodes; ++node) {
+            out << "  node " << topo.node_ids[node] << ": workers=" << stats.node_workers[node]
+                << ", GBps=" << stats.node_bytes[node] / r.median / 1e6 << "\n";
+        }
+    }
+
+    for (size_t w = 0; w < pool.size(); ++w) pool.unpin_worker(w);
+    out << "\n";
+}
+
+
+int main() {
+
+    std::ofstream out("merge_results.txt");
+    if (!out.is_open()) {
+        std::cerr << "Error: cannot open merge_results.txt\n";
+        return 1;
+    }
+
+    out << "MERGE EXPERIMENTS (Release mode recommended)\n\n";
+    out << "Leaf merge kernel: " << merge_int_kernel().name << "\n";
+
+    size_t hw = std::thread::hardware_concurrency();
+
+    std::unique_ptr<ThreadPool> pool;
+    bench::Options once;
+    once.warmup = 0;
+    once.samples = 1;
+
+    double pool_startup_ms = bench::run("thread_pool_startup", [&]() {
+        pool = std::make_unique<ThreadPool>(hw > 1 ? hw - 1 : 0);
+        }, once).median;
+
+    out << "Thread pool: workers=" << pool->size()
+        << " (+ calling thread), startup_ms=" << pool_startup_ms << "\n\n";
+
+    std::vector<size_t> sizes = { 100000, 300000, 1000000 };
+
+    for (size_t n : sizes) {
+        run_std_merge_benchmarks(out, n);
+        run_custom_parallel_benchmarks(*pool, out, n);
+        run_merge_path_benchmarks(*pool, out, n);
+        run_kway_merge_benchmarks(*pool, out, n);
+        run_record_merge_benchmarks(*pool, out, n);
+        run_numa_merge_benchmarks(*pool, out, n);
+    }
+
+    run_streaming_merge_benchmarks(*pool, out, size_t(32) << 20, size_t(8) << 20);
+
+    bench::default_report().write_csv("merge_results.csv");
+    bench::default_report().write_json("merge_results.json");
+
     return 0;
 }
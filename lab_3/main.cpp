@@ -2,195 +2,695 @@
 #include <syncstream>
 #include <thread>
 #include <barrier>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
-constexpr int nt = 3; //   
+#include "../common/trace.h"
 
-//      3 
-std::barrier sync_point{nt};
+constexpr int nt = 3; //     
+
+//   :      action_work ( ,
+//     ,     )
+std::chrono::microseconds action_work{0};
 
 
 void f(char x, int i)
 {
-    // osyncstream      
+    //    osyncstream (  stdout) -   
+    //   ;      (print_log)
+    trace::Scope scope(std::string_view(&x, 1), i);
+
+    if (action_work.count() > 0) std::this_thread::sleep_for(action_work);
+}
+
+
+//       -   ,    f()
+void print_log()
+{
+    auto events = trace::collector().events();
+    std::stable_sort(events.begin(), events.end(), [](const trace::Event& a, const trace::Event& b) {
+        return a.start_ns + a.duration_ns < b.start_ns + b.duration_ns;
+    });
+
     std::osyncstream out(std::cout);
-    out << "  " << x << "   " << i << ".\n";
-}
-
-
-void worker(int id)
-{
-    // -----------------  1: a, d -----------------
-    //   ( 9 = 3 * 3,  3   ):
-    //
-    // a = 4:  T0: 2 䳿, T1: 1 , T2: 1 
-    // d = 5:  T0: 1 , T1: 2 䳿, T2: 2 䳿
-
-    if (id == 0) {
-        f('a', 1);
-        f('a', 2);
-        f('d', 1);
-    } else if (id == 1) {
-        f('a', 3);
-        f('d', 2);
-        f('d', 3);
-    } else { // id == 2
-        f('a', 4);
-        f('d', 4);
-        f('d', 5);
-    }
-
-    sync_point.arrive_and_wait(); //    1
-
-    // -----------------  2: b, c, e, f -----------------
-    //  26 ,    9 / 9 / 8
-    //
-    // b = 6: T0: 1,2   T1: 3,4   T2: 5,6   (2/2/2)
-    // c = 4: T0: 1     T1: 2     T2: 3,4   (1/1/2)
-    // e = 8: T0: 1,2,3 T1: 4,5,6 T2: 7,8   (3/3/2)
-    // f = 8: T0: 1,2,3 T1: 4,5,6 T2: 7,8   (3/3/2)
-
-    if (id == 0) {
-        // b
-        f('b', 1);
-        f('b', 2);
-        // c
-        f('c', 1);
-        // e
-        f('e', 1);
-        f('e', 2);
-        f('e', 3);
-        // f
-        f('f', 1);
-        f('f', 2);
-        f('f', 3);
-    } else if (id == 1) {
-        // b
-        f('b', 3);
-        f('b', 4);
-        // c
-        f('c', 2);
-        // e
-        f('e', 4);
-        f('e', 5);
-        f('e', 6);
-        // f
-        f('f', 4);
-        f('f', 5);
-        f('f', 6);
-    } else { // id == 2
-        // b
-        f('b', 5);
-        f('b', 6);
-        // c
-        f('c', 3);
-        f('c', 4);
-        // e
-        f('e', 7);
-        f('e', 8);
-        // f
-        f('f', 7);
-        f('f', 8);
-    }
-
-    sync_point.arrive_and_wait(); //    2
-
-    // -----------------  3: i, g, h -----------------
-    //    N3 (b,e)  N4 (c,f)
-    //  16 ,  6 / 5 / 5
-    //
-    // i = 4: T0: 1,2   T1: 3      T2: 4        (2/1/1)
-    // g = 5: T0: 1,2   T1: 3,4    T2: 5        (2/2/1)
-    // h = 7: T0: 1,2   T1: 3,4    T2: 5,6,7    (2/2/3)
-
-    if (id == 0) {
-        // i
-        f('i', 1);
-        f('i', 2);
-        // g
-        f('g', 1);
-        f('g', 2);
-        // h
-        f('h', 1);
-        f('h', 2);
-    } else if (id == 1) {
-        // i
-        f('i', 3);
-        // g
-        f('g', 3);
-        f('g', 4);
-        // h
-        f('h', 3);
-        f('h', 4);
-    } else { // id == 2
-        // i
-        f('i', 4);
-        // g
-        f('g', 5);
-        // h
-        f('h', 5);
-        f('h', 6);
-        f('h', 7);
-    }
-
-    sync_point.arrive_and_wait(); //    3
-
-    // -----------------  4: j, k -----------------
-    //    ,   i,h  g
-    //  13 ,  5 / 4 / 4
-    //
-    // j = 5: T0: 1,2   T1: 3      T2: 4,5     (2/1/2)
-    // k = 8: T0: 1,2,3 T1: 4,5,6  T2: 7,8     (3/3/2)
-
-    if (id == 0) {
-        // j
-        f('j', 1);
-        f('j', 2);
-        // k
-        f('k', 1);
-        f('k', 2);
-        f('k', 3);
-    } else if (id == 1) {
-        // j
-        f('j', 3);
-        // k
-        f('k', 4);
-        f('k', 5);
-        f('k', 6);
-    } else { // id == 2
-        // j
-        f('j', 4);
-        f('j', 5);
-        // k
-        f('k', 7);
-        f('k', 8);
-    }
-
-}
-
-
-int main()
+    for (const auto& e : events) {
+        out << "  " << e.name << "   " << e.index << ".\n";
+    }
+}
+
+
+// -----------------   -----------------
+//  =  : ,    ,      .
+//        :
+//  3    N3 (b,e)  N4 (c,f),  4 -  ,
+//   i,h  g.
+//   constexpr-:        
+// (. ),     -  graph   .
+struct GraphSpec
 {
-    setlocale(LC_ALL, "Ukr");
+    char name;
+    int actions;
+    const char* deps;   //  
+};
+
+constexpr GraphSpec graph_spec[] = {
+    {'a', 4, ""},   {'d', 5, ""},
+    {'b', 6, "ad"}, {'c', 4, "ad"}, {'e', 8, "ad"}, {'f', 8, "ad"},
+    {'i', 4, "be"}, {'g', 5, "cf"}, {'h', 7, "be"},
+    {'j', 5, "ih"}, {'k', 8, "g"},
+};
+
+constexpr int graph_size = int(std::size(graph_spec));
+
+struct Node
+{
+    char name;
+    int actions;
+    std::vector<char> deps;
+};
+
+std::vector<Node> nodes_from_spec()
+{
+    std::vector<Node> nodes;
+    for (const auto& spec : graph_spec) {
+        nodes.push_back({spec.name, spec.actions, std::vector<char>(spec.deps, spec.deps + std::char_traits<char>::length(spec.deps))});
+    }
+    return nodes;
+}
+
+const std::vector<Node> graph = nodes_from_spec();
 
+//  : f(node, index)
+struct Task
+{
+    char node;
+    int index;
+};
+
+//  =   :    1    
+//  .  䳿         .
+std::vector<std::vector<Task>> build_phases(const std::vector<Node>& nodes)
+{
+    std::map<char, int> level;
+    std::map<char, const Node*> by_name;
+    for (const auto& n : nodes) by_name[n.name] = &n;
+
+    //   :    ,      
+    size_t resolved = 0;
+    while (resolved < nodes.size()) {
+        size_t before = resolved;
+        for (const auto& n : nodes) {
+            if (level.count(n.name)) continue;
+
+            int l = 0;
+            bool ready = true;
+            for (char d : n.deps) {
+                if (!by_name.count(d)) throw std::runtime_error(std::string("unknown dependency ") + d);
+                auto it = level.find(d);
+                if (it == level.end()) { ready = false; break; }
+                l = std::max(l, it->second + 1);
+            }
+            if (ready) {
+                level[n.name] = l;
+                ++resolved;
+            }
+        }
+        if (resolved == before) throw std::runtime_error("task graph has a cycle");
+    }
+
+    int depth = 0;
+    for (const auto& [name, l] : level) depth = std::max(depth, l + 1);
+
+    std::vector<std::vector<Task>> phases(depth);
+    for (const auto& n : nodes) {
+        for (int i = 1; i <= n.actions; ++i) {
+            phases[level[n.name]].push_back({n.name, i});
+        }
+    }
+    return phases;
+}
+
+
+// -----------------   -----------------
+// -  .     䳿   
+//  ;     -   .
+// ĳ [begin, end)   -  64-  ,
+//    (  ),   ( )   CAS  '.
+// ̳  - ';   '    .
+class PhaseScheduler
+{
+public:
+    PhaseScheduler(std::vector<std::vector<Task>> phases, int threads)
+        : phases(std::move(phases)), threads(std::max(1, threads)),
+          ranges(this->threads), executed(this->threads, 0), stolen(this->threads, 0),
+          sync_point(this->threads, NextPhase{this})
     {
-        std::osyncstream out(std::cout);
-        out << "Calculate start.\n";
     }
 
-    //   nt=3  
-    std::thread t0(worker, 0);
-    std::thread t1(worker, 1);
-    std::thread t2(worker, 2);
+    void run()
+    {
+        current = 0;
+        prepare_phase();
+
+        std::vector<std::thread> workers;
+        for (int id = 0; id < threads; ++id) {
+            workers.emplace_back(&PhaseScheduler::worker, this, id);
+        }
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+
+    //             
+    const std::vector<int>& executed_per_thread() const { return executed; }
+    const std::vector<int>& stolen_per_thread() const { return stolen; }
 
-    //   
-    t0.join();
-    t1.join();
-    t2.join();
+private:
+    struct NextPhase
+    {
+        PhaseScheduler* self;
+        void operator()() noexcept
+        {
+            ++self->current;
+            self->prepare_phase();
+        }
+    };
 
+    struct alignas(64) Range
     {
+        std::atomic<uint64_t> bits{0};
+    };
+
+    static uint64_t pack(uint32_t begin, uint32_t end) { return (uint64_t(begin) << 32) | end; }
+    static uint32_t begin_of(uint64_t r) { return uint32_t(r >> 32); }
+    static uint32_t end_of(uint64_t r) { return uint32_t(r); }
+
+    void prepare_phase()
+    {
+        if (current >= phases.size()) return;
+        size_t n = phases[current].size();
+        for (int id = 0; id < threads; ++id) {
+            ranges[id].bits.store(pack(uint32_t(n * id / threads), uint32_t(n * (id + 1) / threads)),
+                                  std::memory_order_relaxed);
+        }
+    }
+
+    bool take_own(int id, uint32_t& index)
+    {
+        uint64_t r = ranges[id].bits.load(std::memory_order_acquire);
+        while (begin_of(r) < end_of(r)) {
+            if (ranges[id].bits.compare_exchange_weak(r, pack(begin_of(r) + 1, end_of(r)),
+                                                      std::memory_order_acq_rel)) {
+                index = begin_of(r);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //       :    ,
+    //     ( ,  ,   )
+    bool steal(int id, uint32_t& index)
+    {
+        for (int k = 1; k < threads; ++k) {
+            int victim = (id + k) % threads;
+            uint64_t r = ranges[victim].bits.load(std::memory_order_acquire);
+            while (begin_of(r) < end_of(r)) {
+                uint32_t b = begin_of(r), e = end_of(r);
+                uint32_t mid = b + (e - b) / 2;
+                if (ranges[victim].bits.compare_exchange_weak(r, pack(b, mid), std::memory_order_acq_rel)) {
+                    index = mid;
+                    ranges[id].bits.store(pack(mid + 1, e), std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void worker(int id)
+    {
+        for (size_t p = 0; p < phases.size(); ++p) {
+            const auto& tasks = phases[p];
+            uint32_t index;
+            while (true) {
+                if (take_own(id, index)) {
+                    ++executed[id];
+                } else if (steal(id, index)) {
+                    ++executed[id];
+                    ++stolen[id];
+                } else {
+                    break;
+                }
+                f(tasks[index].node, tasks[index].index);
+            }
+
+            sync_point.arrive_and_wait(); //   
+        }
+    }
+
+    std::vector<std::vector<Task>> phases;
+    int threads;
+    std::vector<Range> ranges;
+    std::vector<int> executed;
+    std::vector<int> stolen;
+    size_t current = 0;
+    std::barrier<NextPhase> sync_point;
+};
+
+
+// -----------------   -----------------
+//     nt      :
+//   ,    build_phases,       
+// " " / "'  ".   -      ,
+//           .
+//    nt   ;    .
+
+//    ( , )     =  
+constexpr int spec_index(char name)
+{
+    for (int i = 0; i < graph_size; ++i) {
+        if (graph_spec[i].name == name) return i;
+    }
+    throw std::logic_error("unknown dependency");
+}
+
+constexpr std::array<int, graph_size> spec_levels()
+{
+    std::array<int, graph_size> level{};
+    level.fill(-1);
+
+    int resolved = 0;
+    while (resolved < graph_size) {
+        int before = resolved;
+        for (int i = 0; i < graph_size; ++i) {
+            if (level[i] >= 0) continue;
+
+            int l = 0;
+            bool ready = true;
+            for (const char* d = graph_spec[i].deps; *d; ++d) {
+                int j = spec_index(*d);
+                if (level[j] < 0) { ready = false; break; }
+                l = std::max(l, level[j] + 1);
+            }
+            if (ready) {
+                level[i] = l;
+                ++resolved;
+            }
+        }
+        if (resolved == before) throw std::logic_error("task graph has a cycle");
+    }
+    return level;
+}
+
+constexpr auto graph_levels = spec_levels();
+
+constexpr int graph_depth()
+{
+    int depth = 0;
+    for (int l : graph_levels) depth = std::max(depth, l + 1);
+    return depth;
+}
+
+constexpr int phase_size(int phase)
+{
+    int n = 0;
+    for (int i = 0; i < graph_size; ++i) {
+        if (graph_levels[i] == phase) n += graph_spec[i].actions;
+    }
+    return n;
+}
+
+// node == 0 - '  
+struct StaticInstr
+{
+    char node;
+    int index;
+};
+
+// k-      ,    build_phases
+constexpr StaticInstr phase_task(int phase, int k)
+{
+    for (int i = 0; i < graph_size; ++i) {
+        if (graph_levels[i] != phase) continue;
+        if (k < graph_spec[i].actions) return {graph_spec[i].name, k + 1};
+        k -= graph_spec[i].actions;
+    }
+    throw std::logic_error("phase task out of range");
+}
+
+template <int Threads>
+struct StaticSchedule
+{
+    //     :      + '
+    static constexpr int capacity = [] {
+        int c = graph_depth() - 1;
+        for (int p = 0; p < graph_depth(); ++p) c += (phase_size(p) + Threads - 1) / Threads;
+        return c;
+    }();
+
+    std::array<std::array<StaticInstr, capacity>, Threads> program{};
+    std::array<int, Threads> length{};
+    std::array<int, Threads> load{};   //     '
+};
+
+//    n       n / Threads ,   n % Threads
+//    䳿   ,   ,     , -
+//           
+template <int Threads>
+constexpr StaticSchedule<Threads> make_static_schedule()
+{
+    static_assert(Threads > 0, "static schedule needs at least one thread");
+
+    StaticSchedule<Threads> s{};
+    int carry = 0;
+    for (int p = 0; p < graph_depth(); ++p) {
+        int n = phase_size(p);
+        int base = n / Threads, extra = n % Threads;
+        int k = 0;
+        for (int t = 0; t < Threads; ++t) {
+            int count = base + ((t - carry + Threads) % Threads < extra ? 1 : 0);
+            for (int c = 0; c < count; ++c) {
+                s.program[t][s.length[t]++] = phase_task(p, k++);
+                ++s.load[t];
+            }
+            if (p + 1 < graph_depth()) s.program[t][s.length[t]++] = {0, 0};
+        }
+        carry = (carry + extra) % Threads;
+    }
+    return s;
+}
+
+template <int Threads>
+constexpr StaticSchedule<Threads> static_schedule = make_static_schedule<Threads>();
+
+//      ,    make_static_schedule:
+//   '   graph_depth() ;   p    
+//  ceil(phase_size(p) / Threads) ; 䳿  p,    0..Threads-1,
+//  phase_task(p, 0..n-1) -        ; load   
+template <int Threads>
+constexpr bool static_schedule_valid()
+{
+    const auto& s = static_schedule<Threads>;
+    std::array<int, Threads> pos{}, load{};
+    for (int p = 0; p < graph_depth(); ++p) {
+        int n = phase_size(p);
+        int limit = (n + Threads - 1) / Threads;
+        int k = 0;
+        for (int t = 0; t < Threads; ++t) {
+            int count = 0;
+            for (; pos[t] < s.length[t] && s.program[t][pos[t]].node != 0; ++pos[t], ++count) {
+                if (k >= n) return false;
+                StaticInstr want = phase_task(p, k++);
+                if (s.program[t][pos[t]].node != want.node || s.program[t][pos[t]].index != want.index) return false;
+            }
+            if (count > limit) return false;
+            load[t] += count;
+
+            if (p + 1 < graph_depth()) {
+                if (pos[t] == s.length[t]) return false;
+                ++pos[t];   // '  
+            }
+        }
+        if (k != n) return false;
+    }
+    for (int t = 0; t < Threads; ++t) {
+        if (pos[t] != s.length[t] || load[t] != s.load[t]) return false;
+    }
+    return true;
+}
+
+static_assert(static_schedule_valid<nt>(), "static schedule for nt threads is invalid");
+
+template <int Threads, int Id>
+void static_worker(std::barrier<>& sync_point)
+{
+    constexpr const auto& plan = static_schedule<Threads>;
+    const StaticInstr* p = plan.program[Id].data();
+    const StaticInstr* end = p + plan.length[Id];
+    for (; p != end; ++p) {
+        if (p->node == 0) sync_point.arrive_and_wait();
+        else f(p->node, p->index);
+    }
+}
+
+template <int Threads, int... Ids>
+void launch_static_workers(std::barrier<>& sync_point, std::integer_sequence<int, Ids...>)
+{
+    std::thread workers[] = {std::thread(&static_worker<Threads, Ids>, std::ref(sync_point))...};
+    for (auto& t : workers) {
+        t.join();
+    }
+}
+
+template <int Threads>
+void run_static_schedule()
+{
+    std::barrier<> sync_point(Threads);
+    launch_static_workers<Threads>(sync_point, std::make_integer_sequence<int, Threads>{});
+}
+
+
+// -----------------    -----------------
+//   ':      
+//    .     , 
+//   ,  ,     0,     䳿
+//     .
+class DataflowScheduler
+{
+public:
+    DataflowScheduler(const std::vector<Node>& nodes, int threads)
+        : nodes(nodes), threads(std::max(1, threads)), state(nodes.size())
+    {
+        std::map<char, size_t> index;
+        for (size_t i = 0; i < nodes.size(); ++i) index[nodes[i].name] = i;
+
+        successors.resize(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            for (char d : nodes[i].deps) {
+                auto it = index.find(d);
+                if (it == index.end()) throw std::runtime_error(std::string("unknown dependency ") + d);
+                successors[it->second].push_back(i);
+            }
+        }
+    }
+
+    void run()
+    {
+        remaining_total = 0;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            state[i].pending_deps.store(int(nodes[i].deps.size()));
+            state[i].remaining.store(nodes[i].actions);
+            remaining_total += nodes[i].actions;
+        }
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].deps.empty()) release(i);
+        }
+
+        std::vector<std::thread> workers;
+        for (int id = 0; id < threads; ++id) {
+            workers.emplace_back(&DataflowScheduler::worker, this);
+        }
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+
+private:
+    struct NodeState
+    {
+        std::atomic<int> pending_deps{0};
+        std::atomic<int> remaining{0};
+    };
+
+    struct ReadyTask
+    {
+        size_t node;
+        int index;
+    };
+
+    //    :   䳿 -  
+    void release(size_t node)
+    {
+        //         
+        if (nodes[node].actions == 0) {
+            finish(node);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m);
+            for (int i = 1; i <= nodes[node].actions; ++i) ready.push_back({node, i});
+        }
+        cv.notify_all();
+    }
+
+    void finish(size_t node)
+    {
+        for (size_t s : successors[node]) {
+            if (state[s].pending_deps.fetch_sub(1, std::memory_order_acq_rel) == 1) release(s);
+        }
+    }
+
+    void worker()
+    {
+        while (true) {
+            ReadyTask task;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [&] { return !ready.empty() || remaining_total == 0; });
+                if (ready.empty()) return;
+                task = ready.front();
+                ready.pop_front();
+            }
+
+            f(nodes[task.node].name, task.index);
+
+            if (state[task.node].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) finish(task.node);
+
+            bool done;
+            {
+                std::lock_guard<std::mutex> lock(m);
+                done = --remaining_total == 0;
+            }
+            if (done) cv.notify_all();
+        }
+    }
+
+    const std::vector<Node>& nodes;
+    int threads;
+    std::vector<NodeState> state;
+    std::vector<std::vector<size_t>> successors;
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<ReadyTask> ready;
+    int remaining_total = 0;
+};
+
+//      (䳿     ,
+//         )
+int critical_path_nodes(const std::vector<Node>& nodes)
+{
+    auto phases = build_phases(nodes);
+    std::map<char, int> longest;
+    // build_phases   ;    
+    for (const auto& phase : phases) {
+        for (const auto& task : phase) {
+            if (task.index != 1) continue;
+            const Node& n = *std::find_if(nodes.begin(), nodes.end(), [&](const Node& x) { return x.name == task.node; });
+            int l = 0;
+            for (char d : n.deps) l = std::max(l, longest[d]);
+            longest[n.name] = l + 1;
+        }
+    }
+    int result = 0;
+    for (const auto& [name, l] : longest) result = std::max(result, l);
+    return result;
+}
+
+//        "" 䳿:  
+//    -       /  
+void compare_schedulers(int threads, std::chrono::microseconds work)
+{
+    action_work = work;
+
+    int total = 0;
+    for (const auto& n : graph) total += n.actions;
+    double w = std::chrono::duration<double, std::milli>(work).count();
+    double critical = critical_path_nodes(graph) * w;
+    double bound = std::max(critical, total * w / threads);
+
+    auto measure = [](auto&& run) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    double phased = measure([&] {
+        PhaseScheduler scheduler(build_phases(graph), threads);
+        scheduler.run();
+    });
+    double dataflow = measure([&] {
+        DataflowScheduler scheduler(graph, threads);
+        scheduler.run();
+    });
+    //      nt 
+    double fixed = threads == nt ? measure([] { run_static_schedule<nt>(); }) : 0;
+
+    action_work = std::chrono::microseconds{0};
+
+    std::osyncstream out(std::cout);
+    out << ": " << threads << ", : " << total << ",  : " << w << " \n"
+        << " : " << critical_path_nodes(graph) << "  = " << critical << " , "
+        << "  (max      / ): " << bound << " \n"
+        << " ':        " << phased << "  (" << phased / bound << " x )\n"
+        << " :    " << dataflow << "  (" << dataflow / bound << " x )\n";
+    if (threads == nt) {
+        out << " :  " << fixed << "  (" << fixed / bound << " x )\n";
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    setlocale(LC_ALL, "Ukr");
+
+    // : [ ,   nt] [phases | dataflow | static | compare];
+    // static    nt  -       
+    int threads = argc > 1 ? std::max(1, std::atoi(argv[1])) : nt;
+    std::string mode = argc > 2 ? argv[2] : "phases";
+
+    // 䳿       ;  -  trace.json / trace.bin
+    trace::collector().start();
+
+    if (mode == "compare") {
+        compare_schedulers(threads, std::chrono::microseconds{2000});
+    } else {
+        {
+            std::osyncstream out(std::cout);
+            out << "Calculate start.\n";
+        }
+
+        std::vector<int> executed, stolen;
+        if (mode == "static") {
+            run_static_schedule<nt>();
+            const auto& plan = static_schedule<nt>;
+            executed.assign(plan.load.begin(), plan.load.end());
+            stolen.assign(nt, 0);
+        } else if (mode == "dataflow") {
+            DataflowScheduler scheduler(graph, threads);
+            scheduler.run();
+        } else {
+            PhaseScheduler scheduler(build_phases(graph), threads);
+            scheduler.run();
+            executed = scheduler.executed_per_thread();
+            stolen = scheduler.stolen_per_thread();
+        }
+
+        print_log();
+
         std::osyncstream out(std::cout);
         out << "Calculate end.\n";
+        for (size_t id = 0; id < executed.size(); ++id) {
+            out << " " << id << ":  " << executed[id] << ",    " << stolen[id] << ".\n";
+        }
     }
 
+    trace::collector().stop();
+    trace::collector().write_chrome_json("trace.json");
+    trace::collector().write_binary("trace.bin");
+
     return 0;
 }
@@ -1,5 +1,6 @@
 #include <sstream>
 #include <iostream>
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -7,43 +8,747 @@
 #include <chrono>
 #include <fstream>
 #include <random>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <string_view>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <barrier>
+#include <stdexcept>
+#include <iterator>
+#include <bit>
 
-class MultiThreadedData {
-private:
+#include "../common/bench.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// розмір кеш-лінії, на яку вирівнюються поля в режимі Padded
+#ifdef __cpp_lib_hardware_interference_size
+constexpr std::size_t cacheLineSize = std::hardware_destructive_interference_size;
+#else
+constexpr std::size_t cacheLineSize = 64;
+#endif
+
+// форматує знімок полів у out ("Fields: [a, b, c]"), перевикористовуючи його буфер;
+// викликається вже після виходу з критичної секції, тож письменники на нього не чекають
+inline void formatFields(const int* values, std::size_t count, std::string& out) {
+    out.clear();
+    out += "Fields: [";
+    char digits[16];
+    for (std::size_t i = 0; i < count; ++i) {
+        auto end = std::to_chars(digits, digits + sizeof(digits), values[i]).ptr;
+        out.append(digits, end);
+        if (i + 1 < count) out += ", ";
+    }
+    out += "]";
+}
+
+// розкладка полів і м'ютексів у пам'яті.
+// Padded = false — як було: три поля підряд, за ними три м'ютекси; усе це
+// лежить в одній-двох кеш-лініях, тож потоки, що працюють з різними полями,
+// однаково "перекидають" ці лінії між ядрами (false sharing).
+template <bool Padded>
+struct MutexFieldLayout {
     int fields[3];            // три цілі поля
     std::mutex mutexes[3];    // по одному м'ютексу на кожне поле
 
+    int& value(int index) { return fields[index]; }
+    std::mutex& mutex(int index) { return mutexes[index]; }
+};
+
+// Padded = true — кожне поле разом зі своїм м'ютексом займає окрему кеш-лінію
+template <>
+struct MutexFieldLayout<true> {
+    struct alignas(cacheLineSize) Slot {
+        int value;
+        std::mutex mutex;
+    };
+    Slot slots[3];
+
+    int& value(int index) { return slots[index].value; }
+    std::mutex& mutex(int index) { return slots[index].mutex; }
+};
+
+template <bool Padded>
+class BasicMultiThreadedData {
+private:
+    MutexFieldLayout<Padded> layout;
+
 public:
-    MultiThreadedData() {
+    static constexpr const char* name = Padded ? "mutex-padded" : "mutex";
+
+    BasicMultiThreadedData() {
         for (int i = 0; i < 3; ++i) {
-            fields[i] = 0;
+            layout.value(i) = 0;
         }
     }
 
     void write(int index, int value) {
         if (index < 0 || index >= 3) return;
-        std::lock_guard<std::mutex> lock(mutexes[index]);
-        fields[index] = value;
+        std::lock_guard<std::mutex> lock(layout.mutex(index));
+        layout.value(index) = value;
     }
 
     int read(int index) {
         if (index < 0 || index >= 3) return -1;
-        std::lock_guard<std::mutex> lock(mutexes[index]);
+        std::lock_guard<std::mutex> lock(layout.mutex(index));
+        return layout.value(index);
+    }
+
+    // пакет записів від WriteCombiner: поля з mask отримують values[i]; м'ютекси
+    // змінених полів захоплюються один раз і по зростанню індексу
+    void publish(const int values[3], unsigned mask) {
+        for (int i = 0; i < 3; ++i) {
+            if (mask & (1u << i)) layout.mutex(i).lock();
+        }
+        for (int i = 0; i < 3; ++i) {
+            if (mask & (1u << i)) {
+                layout.value(i) = values[i];
+                layout.mutex(i).unlock();
+            }
+        }
+    }
+
+    // узгоджений знімок: під усіма трьома м'ютексами лише копіюються три числа
+    void snapshot(int out[3]) {
+        std::scoped_lock lock(layout.mutex(0), layout.mutex(1), layout.mutex(2));
+        for (int i = 0; i < 3; ++i) {
+            out[i] = layout.value(i);
+        }
+    }
+
+    // форматування — вже без блокувань, у буфер, який можна перевикористати
+    void to_string(std::string& out) {
+        int values[3];
+        snapshot(values);
+        formatFields(values, 3, out);
+    }
+
+    std::string to_string() {
+        std::string result;
+        to_string(result);
+        return result;
+    }
+};
+
+using MultiThreadedData = BasicMultiThreadedData<false>;
+using PaddedMultiThreadedData = BasicMultiThreadedData<true>;
+
+// те саме для атомарних полів: або масив std::atomic<int> підряд,
+// або кожне атомарне поле у власній кеш-лінії
+template <bool Padded>
+struct AtomicFieldLayout {
+    std::atomic<int> fields[3];
+
+    std::atomic<int>& value(int index) { return fields[index]; }
+};
+
+template <>
+struct AtomicFieldLayout<true> {
+    struct alignas(cacheLineSize) Slot {
+        std::atomic<int> value;
+    };
+    Slot slots[3];
+
+    std::atomic<int>& value(int index) { return slots[index].value; }
+};
+
+// той самий інтерфейс, але кожне поле — std::atomic<int> без жодних блокувань;
+// read/write не чекають одне на одного, а to_string читає поля по черзі
+// (кожне значення коректне, але знімок у цілому не обов'язково узгоджений)
+template <bool Padded>
+class BasicAtomicMultiThreadedData {
+private:
+    AtomicFieldLayout<Padded> layout;
+
+public:
+    static constexpr const char* name = Padded ? "atomic-padded" : "atomic";
+
+    BasicAtomicMultiThreadedData() {
+        for (int i = 0; i < 3; ++i) {
+            layout.value(i).store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void write(int index, int value) {
+        if (index < 0 || index >= 3) return;
+        layout.value(index).store(value, std::memory_order_release);
+    }
+
+    int read(int index) {
+        if (index < 0 || index >= 3) return -1;
+        return layout.value(index).load(std::memory_order_acquire);
+    }
+
+    void publish(const int values[3], unsigned mask) {
+        for (int i = 0; i < 3; ++i) {
+            if (mask & (1u << i)) layout.value(i).store(values[i], std::memory_order_release);
+        }
+    }
+
+    void to_string(std::string& out) {
+        int values[3];
+        for (int i = 0; i < 3; ++i) {
+            values[i] = layout.value(i).load(std::memory_order_acquire);
+        }
+        formatFields(values, 3, out);
+    }
+
+    std::string to_string() {
+        std::string result;
+        to_string(result);
+        return result;
+    }
+};
+
+using AtomicMultiThreadedData = BasicAtomicMultiThreadedData<false>;
+using PaddedAtomicMultiThreadedData = BasicAtomicMultiThreadedData<true>;
+
+// seqlock: читачі не блокуються взагалі, а to_string отримує узгоджений знімок
+// усіх трьох полів — якщо під час читання лічильник seq змінився, читаємо ще раз.
+// Письменники впорядковуються між собою одним м'ютексом (запис — лише 25% дій).
+class SeqlockMultiThreadedData {
+private:
+    std::atomic<int> fields[3];
+    std::atomic<unsigned> seq{ 0 };   // непарне значення — запис триває
+    std::mutex writeMutex;
+
+public:
+    static constexpr const char* name = "seqlock";
+
+    SeqlockMultiThreadedData() {
+        for (int i = 0; i < 3; ++i) {
+            fields[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void write(int index, int value) {
+        if (index < 0 || index >= 3) return;
+        std::lock_guard<std::mutex> lock(writeMutex);
+
+        unsigned s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        fields[index].store(value, std::memory_order_relaxed);
+
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // увесь пакет — одна пара інкрементів seq під одним захопленням writeMutex
+    void publish(const int values[3], unsigned mask) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+
+        unsigned s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < 3; ++i) {
+            if (mask & (1u << i)) fields[i].store(values[i], std::memory_order_relaxed);
+        }
+
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    int read(int index) {
+        if (index < 0 || index >= 3) return -1;
+        // одне поле читається атомарно, узгоджувати його з іншими не треба
+        return fields[index].load(std::memory_order_acquire);
+    }
+
+    void snapshot(int out[3]) {
+        while (true) {
+            unsigned before = seq.load(std::memory_order_acquire);
+            if (before & 1) continue;
+
+            for (int i = 0; i < 3; ++i) {
+                out[i] = fields[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == before) return;
+        }
+    }
+
+    void to_string(std::string& out) {
+        int values[3];
+        snapshot(values);
+        formatFields(values, 3, out);
+    }
+
+    std::string to_string() {
+        std::string result;
+        to_string(result);
+        return result;
+    }
+};
+
+// та сама структура для довільної кількості полів: N полів під M м'ютексами (lock striping),
+// обидва числа задаються під час виконання. Смуга s охоплює суцільний блок полів
+// [s * fieldsPerStripe, (s + 1) * fieldsPerStripe), тож поля однієї кеш-лінії
+// майже завжди належать одній смузі й не "перекидаються" між потоками різних смуг.
+class StripedMultiThreadedData {
+private:
+    struct alignas(cacheLineSize) Stripe {
+        std::mutex mutex;
+    };
+
+    std::vector<int> fields;
+    std::vector<Stripe> stripes;
+    std::size_t fieldsPerStripe;
+
+    std::mutex& stripeFor(int index) { return stripes[std::size_t(index) / fieldsPerStripe].mutex; }
+
+public:
+    static constexpr const char* name = "striped";
+
+    explicit StripedMultiThreadedData(std::size_t fieldCount = 3, std::size_t stripeCount = 3)
+        : fields(std::max<std::size_t>(fieldCount, 1), 0),
+        stripes(std::clamp<std::size_t>(stripeCount, 1, std::max<std::size_t>(fieldCount, 1))),
+        fieldsPerStripe((fields.size() + stripes.size() - 1) / stripes.size()) {
+    }
+
+    std::size_t fieldCount() const { return fields.size(); }
+    std::size_t stripeCount() const { return stripes.size(); }
+
+    void write(int index, int value) {
+        if (index < 0 || std::size_t(index) >= fields.size()) return;
+        std::lock_guard<std::mutex> lock(stripeFor(index));
+        fields[index] = value;
+    }
+
+    int read(int index) {
+        if (index < 0 || std::size_t(index) >= fields.size()) return -1;
+        std::lock_guard<std::mutex> lock(stripeFor(index));
         return fields[index];
     }
 
+    // узгоджений знімок у out (його ємність перевикористовується між викликами).
+    // Усі смуги блокуються в порядку зростання номера — так само роблять
+    // усі потоки, тож взаємного блокування немає; під блокуванням лише memcpy.
+    void snapshot(std::vector<int>& out) {
+        out.resize(fields.size());
+        for (auto& stripe : stripes) stripe.mutex.lock();
+        std::copy(fields.begin(), fields.end(), out.begin());
+        for (auto& stripe : stripes) stripe.mutex.unlock();
+    }
+
+    void to_string(std::string& out) {
+        thread_local std::vector<int> values;
+        snapshot(values);
+        formatFields(values.data(), values.size(), out);
+    }
+
+    std::string to_string() {
+        std::string result;
+        to_string(result);
+        return result;
+    }
+};
+
+// ---------- великі записи замість int ----------
+// поле — запис на кілька сотень байт; write заповнює весь запис одним значенням,
+// read "використовує" запис повністю (сума елементів), тож розірваний запис видно одразу
+constexpr std::size_t recordInts = 96;   // 384 байти
+
+struct LargeRecord {
+    int values[recordInts];
+};
+
+inline void fillRecord(LargeRecord& record, int value) {
+    std::fill(std::begin(record.values), std::end(record.values), value);
+}
+
+inline int recordSum(const LargeRecord& record) {
+    int sum = 0;
+    for (int v : record.values) sum += v;
+    return sum;
+}
+
+// базовий варіант: запис під м'ютексом поля; читач копіює весь запис під блокуванням
+class LargeRecordMutexData {
+private:
+    LargeRecord records[3];
+    std::mutex mutexes[3];
+
+public:
+    static constexpr const char* name = "record-mutex";
+
+    LargeRecordMutexData() {
+        for (auto& record : records) fillRecord(record, 0);
+    }
+
+    void write(int index, int value) {
+        if (index < 0 || index >= 3) return;
+        LargeRecord fresh;
+        fillRecord(fresh, value);
+
+        std::lock_guard<std::mutex> lock(mutexes[index]);
+        records[index] = fresh;
+    }
+
+    int read(int index) {
+        if (index < 0 || index >= 3) return -1;
+        LargeRecord copy;
+        {
+            std::lock_guard<std::mutex> lock(mutexes[index]);
+            copy = records[index];
+        }
+        return recordSum(copy);
+    }
+
+    void to_string(std::string& out) {
+        int sums[3];
+        {
+            std::scoped_lock lock(mutexes[0], mutexes[1], mutexes[2]);
+            for (int i = 0; i < 3; ++i) sums[i] = recordSum(records[i]);
+        }
+        formatFields(sums, 3, out);
+    }
+
+    std::string to_string() {
+        std::string result;
+        to_string(result);
+        return result;
+    }
+};
+
+// номер живого потоку: видається при першому зверненні й повертається, коли потік
+// завершується, тож одночасно живі потоки мають різні номери. Межі немає —
+// номери беруться зі списку звільнених або наступний за найбільшим виданим
+class ThreadSlot {
+public:
+    ThreadSlot() {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        auto& freeIndices = released();
+        if (!freeIndices.empty()) {
+            index = freeIndices.back();
+            freeIndices.pop_back();
+        } else {
+            index = highWater().load(std::memory_order_relaxed);
+            highWater().store(index + 1, std::memory_order_release);
+        }
+    }
+
+    ~ThreadSlot() {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        released().push_back(index);
+    }
+
+    ThreadSlot(const ThreadSlot&) = delete;
+    ThreadSlot& operator=(const ThreadSlot&) = delete;
+
+    int index = -1;
+
+    // верхня межа номерів, які будь-коли видавалися (скільки слотів переглядати)
+    static std::atomic<int>& highWater() {
+        static std::atomic<int> value{ 0 };
+        return value;
+    }
+
+private:
+    static std::mutex& registryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::vector<int>& released() {
+        static std::vector<int> indices;
+        return indices;
+    }
+};
+
+inline int currentThreadSlot() {
+    thread_local ThreadSlot slot;
+    return slot.index;
+}
+
+// епохове звільнення пам'яті (EBR) із пулом вузлів.
+// Читач оголошує поточну глобальну епоху на час доступу (Guard); вузол, знятий
+// письменником в епоху r, повторно використовується, лише коли глобальна епоха
+// досягла r + 2 — тоді жоден читач, що міг його бачити, вже не активний.
+// Вузли виділяються блоками по slabSize і не повертаються системі до знищення домену:
+// звільнені потрапляють у список вільних вузлів потоку й одразу йдуть на наступний write.
+template <typename Node>
+class EpochDomain {
+public:
+    static constexpr std::size_t slabSize = 64;
+    static constexpr std::size_t reclaimThreshold = 16;
+
+    EpochDomain() = default;
+
+    ~EpochDomain() {
+        for (auto& chunk : chunks) delete[] chunk.load(std::memory_order_relaxed);
+    }
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    class Guard {
+    public:
+        explicit Guard(EpochDomain& domain) : slot(domain.slotAt(currentThreadSlot())) {
+            // release: письменник, що побачить це значення, бачить і всі попередні читання цього потоку
+            slot.epoch.store(domain.globalEpoch.load(std::memory_order_relaxed), std::memory_order_release);
+            // оголошення епохи має стати видимим до читання вказівника
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        ~Guard() { slot.epoch.store(0, std::memory_order_release); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        typename EpochDomain::Slot& slot;
+    };
+
+    Node* allocate() {
+        Slot& slot = slotAt(currentThreadSlot());
+        if (slot.freeList.empty()) reclaim(slot);
+        if (slot.freeList.empty()) {
+            auto slab = std::make_unique<Node[]>(slabSize);
+            for (std::size_t i = 0; i < slabSize; ++i) slot.freeList.push_back(&slab[i]);
+
+            std::lock_guard<std::mutex> lock(slabMutex);
+            slabs.push_back(std::move(slab));
+        }
+
+        Node* node = slot.freeList.back();
+        slot.freeList.pop_back();
+        return node;
+    }
+
+    void retire(Node* node) {
+        Slot& slot = slotAt(currentThreadSlot());
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        slot.retired.push_back({ node, globalEpoch.load(std::memory_order_relaxed) });
+        if (slot.retired.size() >= reclaimThreshold) reclaim(slot);
+    }
+
+private:
+    struct alignas(cacheLineSize) Slot {
+        std::atomic<std::uint64_t> epoch{ 0 };    // 0 — потік зараз не читає
+        std::vector<std::pair<Node*, std::uint64_t>> retired;
+        std::vector<Node*> freeList;
+    };
+
+    // слоти лежать у блоках, що подвоюються: блок k містить firstChunkSize << k слотів
+    // і створюється, коли його вперше потребує потік із номером у ньому.
+    // Блоки не переміщуються й не звільняються до знищення домену, тож посилання на слот стабільне,
+    // а maxChunks блоків вистачає на будь-яку реальну кількість потоків
+    static constexpr int firstChunkSize = 64;
+    static constexpr int maxChunks = 24;
+
+    static int chunkOf(int index) {
+        return std::bit_width(unsigned(index / firstChunkSize + 1)) - 1;
+    }
+
+    static int chunkStart(int chunk) {
+        return firstChunkSize * ((1 << chunk) - 1);
+    }
+
+    Slot& slotAt(int index) {
+        int chunk = chunkOf(index);
+        Slot* slots = chunks[chunk].load(std::memory_order_acquire);
+        if (!slots) {
+            Slot* fresh = new Slot[std::size_t(firstChunkSize) << chunk];
+            if (chunks[chunk].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel)) {
+                slots = fresh;
+            } else {
+                delete[] fresh;
+            }
+        }
+        return slots[index - chunkStart(chunk)];
+    }
+
+    // глобальна епоха просувається, лише якщо всі активні читачі вже в ній
+    void tryAdvance() {
+        std::uint64_t current = globalEpoch.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        int high = ThreadSlot::highWater().load(std::memory_order_acquire);
+        for (int chunk = 0; chunk < maxChunks && chunkStart(chunk) < high; ++chunk) {
+            // блоку ще немає — жоден потік із цими номерами ще не оголошував епоху
+            Slot* slots = chunks[chunk].load(std::memory_order_acquire);
+            if (!slots) continue;
+
+            int count = std::min(firstChunkSize << chunk, high - chunkStart(chunk));
+            for (int i = 0; i < count; ++i) {
+                std::uint64_t e = slots[i].epoch.load(std::memory_order_acquire);
+                if (e != 0 && e != current) return;
+            }
+        }
+        globalEpoch.compare_exchange_strong(current, current + 1);
+    }
+
+    void reclaim(Slot& slot) {
+        tryAdvance();
+        std::uint64_t safe = globalEpoch.load(std::memory_order_acquire);
+
+        auto keep = std::partition(slot.retired.begin(), slot.retired.end(),
+            [safe](const auto& r) { return r.second + 2 > safe; });
+        for (auto it = keep; it != slot.retired.end(); ++it) slot.freeList.push_back(it->first);
+        slot.retired.erase(keep, slot.retired.end());
+    }
+
+    std::atomic<std::uint64_t> globalEpoch{ 1 };
+    std::atomic<Slot*> chunks[maxChunks] = {};
+    std::mutex slabMutex;
+    std::vector<std::unique_ptr<Node[]>> slabs;
+};
+
+// RCU-варіант: кожне поле — атомарний вказівник на незмінну версію запису.
+// Читач у межах Guard просто розіменовує поточну версію, без копіювання й блокувань;
+// письменник будує нову версію поза будь-якою критичною секцією та підміняє вказівник.
+class RcuMultiThreadedData {
+private:
+    struct alignas(cacheLineSize) Field {
+        std::atomic<LargeRecord*> current{ nullptr };
+    };
+
+    Field fields[3];
+    EpochDomain<LargeRecord> domain;
+
+public:
+    static constexpr const char* name = "record-rcu";
+
+    RcuMultiThreadedData() {
+        for (auto& field : fields) {
+            LargeRecord* record = domain.allocate();
+            fillRecord(*record, 0);
+            field.current.store(record, std::memory_order_release);
+        }
+    }
+
+    void write(int index, int value) {
+        if (index < 0 || index >= 3) return;
+        LargeRecord* fresh = domain.allocate();
+        fillRecord(*fresh, value);
+
+        LargeRecord* old = fields[index].current.exchange(fresh, std::memory_order_acq_rel);
+        domain.retire(old);
+    }
+
+    int read(int index) {
+        if (index < 0 || index >= 3) return -1;
+        EpochDomain<LargeRecord>::Guard guard(domain);
+        return recordSum(*fields[index].current.load(std::memory_order_acquire));
+    }
+
+    // кожен запис узгоджений сам по собі, але три записи можуть бути з різних моментів
+    // (як і в AtomicMultiThreadedData)
+    void to_string(std::string& out) {
+        int sums[3];
+        {
+            EpochDomain<LargeRecord>::Guard guard(domain);
+            for (int i = 0; i < 3; ++i) sums[i] = recordSum(*fields[i].current.load(std::memory_order_acquire));
+        }
+        formatFields(sums, 3, out);
+    }
+
+    std::string to_string() {
+        std::string result;
+        to_string(result);
+        return result;
+    }
+};
+
+// коли WriteCombiner публікує накопичені записи: після flushCount записів
+// або якщо з першого неопублікованого запису минуло flushInterval (0 — час не перевіряється).
+// Окремого потоку-таймера немає: строк перевіряє сам потік-власник у write, read і poll,
+// тож запис стає видимим іншим потокам не пізніше першої з цих операцій після flushInterval
+// (або flush / to_string / знищення комбайнера). Потік, що надовго перестає звертатися
+// до структури, має сам викликати poll() чи flush(), інакше буфер лишиться неопублікованим.
+struct WriteCombinePolicy {
+    std::size_t flushCount = 16;
+    std::chrono::microseconds flushInterval{ 0 };
+};
+
+// пакетний режим запису для тризначних структур: кожен потік має власний WriteCombiner,
+// що пам'ятає лише останнє значення кожного поля й публікує їх одним Data::publish.
+// Потік одразу бачить власні записи (read повертає буферизоване значення), а перед
+// to_string робить flush. Інші потоки бачать лише опубліковані значення — так само
+// атомарно для кожного поля й так само узгоджено в to_string, як і без пакетування.
+template <typename Data>
+class WriteCombiner {
+public:
+    static constexpr const char* name = Data::name;
+
+    WriteCombiner(Data& data, WriteCombinePolicy policy) : data(data), policy(policy) {}
+    ~WriteCombiner() { flush(); }
+
+    WriteCombiner(const WriteCombiner&) = delete;
+    WriteCombiner& operator=(const WriteCombiner&) = delete;
+
+    void write(int index, int value) {
+        if (index < 0 || index >= 3) return;
+        if (dirtyMask == 0 && policy.flushInterval.count() > 0) {
+            firstPending = std::chrono::steady_clock::now();
+        }
+
+        values[index] = value;
+        dirtyMask |= 1u << index;
+
+        if (++pending >= policy.flushCount || intervalElapsed()) flush();
+    }
+
+    int read(int index) {
+        poll();
+        if (index >= 0 && index < 3 && (dirtyMask & (1u << index))) return values[index];
+        return data.read(index);
+    }
+
+    void to_string(std::string& out) {
+        flush();
+        data.to_string(out);
+    }
+
     std::string to_string() {
-        // для коректного знімка стану — можна заблокувати всі три м’ютекси
-        std::scoped_lock lock(mutexes[0], mutexes[1], mutexes[2]);
+        std::string result;
+        to_string(result);
+        return result;
+    }
 
-        std::string result = "Fields: [";
-        for (int i = 0; i < 3; ++i) {
-            result += std::to_string(fields[i]);
-            if (i < 2) result += ", ";
+    void flush() {
+        if (dirtyMask != 0) {
+            data.publish(values, dirtyMask);
+            ++publishCount;
         }
-        result += "]";
-        return result;
+        dirtyMask = 0;
+        pending = 0;
+    }
+
+    // публікує накопичене, якщо строк flushInterval уже минув
+    void poll() {
+        if (dirtyMask != 0 && intervalElapsed()) flush();
+    }
+
+    std::size_t publishes() const { return publishCount; }
+
+private:
+    bool intervalElapsed() const {
+        return policy.flushInterval.count() > 0
+            && std::chrono::steady_clock::now() - firstPending >= policy.flushInterval;
     }
+
+    Data& data;
+    WriteCombinePolicy policy;
+    int values[3] = {};
+    unsigned dirtyMask = 0;
+    std::size_t pending = 0;
+    std::size_t publishCount = 0;
+    std::chrono::steady_clock::time_point firstPending;
 };
 
 // генерація послідовності дій згідно частот варіанта №9
@@ -87,7 +792,8 @@ void generateActionSequence(const std::string& filename, int totalActions) {
 }
 
 // читаємо файл дій і виконуємо їх над спільною структурою
-void executeActions(MultiThreadedData& data, const std::string& filename) {
+template <typename Data>
+void executeActions(Data& data, const std::string& filename) {
     std::ifstream actionFile(filename);
     if (!actionFile.is_open()) {
         std::cerr << "Unable to open action file: " << filename << std::endl;
@@ -122,9 +828,398 @@ void executeActions(MultiThreadedData& data, const std::string& filename) {
     actionFile.close();
 }
 
+// ---------- компактний бінарний формат дій ----------
+// файл = заголовок (сигнатура + кількість дій) + масив записів по 12 байт;
+// записи вирівняні, тож після mmap їх можна читати напряму, без розбору рядків
+enum class Opcode : std::uint8_t { read = 0, write = 1, string = 2, count };
+
+struct BinaryAction {
+    Opcode opcode;
+    std::uint8_t reserved[3];
+    std::int32_t index;       // int32, бо сховище з розділу нижче має до мільйонів полів
+    std::int32_t value;
+};
+static_assert(sizeof(BinaryAction) == 12, "BinaryAction must stay 12 bytes");
+
+struct BinaryActionHeader {
+    char magic[4];            // "ACT2"
+    std::uint32_t count;      // кількість записів після заголовка
+};
+static_assert(sizeof(BinaryActionHeader) == 8, "BinaryActionHeader must stay 8 bytes");
+
+constexpr char binaryActionMagic[4] = { 'A', 'C', 'T', '2' };
+
+// пропускає пробіли / табуляції / '\r' (рядки з Windows-файлів)
+inline const char* skipBlanks(const char* p, const char* last) {
+    while (p != last && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+inline bool parseInt(const char*& p, const char* last, int& out) {
+    p = skipBlanks(p, last);
+    auto [ptr, ec] = std::from_chars(p, last, out);
+    if (ec != std::errc()) return false;
+    p = ptr;
+    return true;
+}
+
+// розбирає один текстовий рядок [first, last) ("read i", "write i v", "string")
+// без алокацій; false — рядок пропускається, як і в executeActions
+bool parseActionLine(const char* first, const char* last, BinaryAction& action) {
+    const char* p = skipBlanks(first, last);
+    const char* wordEnd = p;
+    while (wordEnd != last && *wordEnd != ' ' && *wordEnd != '\t' && *wordEnd != '\r') ++wordEnd;
+
+    std::string_view command(p, std::size_t(wordEnd - p));
+    p = wordEnd;
+
+    int index = 0, value = 0;
+    action = BinaryAction{};
+    if (command == "write") {
+        if (!parseInt(p, last, index) || !parseInt(p, last, value)) return false;
+        action.opcode = Opcode::write;
+    }
+    else if (command == "read") {
+        if (!parseInt(p, last, index)) return false;
+        action.opcode = Opcode::read;
+    }
+    else if (command == "string") {
+        action.opcode = Opcode::string;
+    }
+    else {
+        return false;
+    }
+
+    action.index = index;
+    action.value = value;
+    return true;
+}
+
+// файл, відображений у пам'ять лише для читання
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) return;
+        bytes = std::size_t(size.QuadPart);
+        if (bytes == 0) {
+            opened = true;
+            return;
+        }
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return;
+
+        base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        opened = base != nullptr;
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) return;
+        bytes = std::size_t(st.st_size);
+        if (bytes == 0) {
+            opened = true;
+            return;
+        }
+
+        void* p = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return;
+
+        base = static_cast<const char*>(p);
+        madvise(p, bytes, MADV_SEQUENTIAL);
+        opened = true;
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(_WIN32)
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (base) munmap(const_cast<char*>(base), bytes);
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return opened; }
+
+    const char* data() const { return base; }
+    std::size_t size() const { return bytes; }
+
+private:
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    const char* base = nullptr;
+    std::size_t bytes = 0;
+    bool opened = false;
+};
+
+// результат паралельного розбору: по масиву дій на кожен потік
+// (шматки файлу йдуть підряд, тож конкатенація масивів зберігає порядок рядків)
+struct ParsedTrace {
+    std::vector<std::vector<BinaryAction>> perThread;
+    std::size_t lines = 0;
+    std::size_t bytes = 0;
+    bool ok = false;
+};
+
+// розбирає шматок [first, last), що складається з цілих рядків
+std::size_t parseActionChunk(const char* first, const char* last, std::vector<BinaryAction>& out) {
+    // найкоротший рядок ("read 0\n") — 7 байт, тож резерву вистачає з запасом
+    out.reserve(std::size_t(last - first) / 7 + 1);
+
+    std::size_t lines = 0;
+    BinaryAction action;
+    while (first != last) {
+        const char* eol = static_cast<const char*>(std::memchr(first, '\n', std::size_t(last - first)));
+        const char* lineEnd = eol ? eol : last;
+
+        if (parseActionLine(first, lineEnd, action)) {
+            out.push_back(action);
+        }
+        ++lines;
+
+        first = eol ? eol + 1 : last;
+    }
+    return lines;
+}
+
+// mmap + поділ файлу на threads шматків по межах рядків + розбір кожного шматка
+// окремим потоком через std::from_chars
+ParsedTrace parseActionTraceParallel(const std::string& filename, int threads) {
+    ParsedTrace result;
+
+    MappedFile file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Unable to map action file: " << filename << std::endl;
+        return result;
+    }
+
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+    threads = std::max(1, threads);
+
+    // межа шматка i — перший символ після '\n', що йде за позицією size * i / threads
+    std::vector<const char*> bounds(threads + 1, end);
+    bounds[0] = begin;
+    for (int i = 1; i < threads; ++i) {
+        const char* p = std::max(bounds[i - 1], begin + file.size() * i / threads);
+        const char* eol = p == end ? nullptr : static_cast<const char*>(std::memchr(p, '\n', std::size_t(end - p)));
+        bounds[i] = eol ? eol + 1 : end;
+    }
+
+    result.perThread.resize(threads);
+    std::vector<std::size_t> lines(threads, 0);
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; ++i) {
+        workers.emplace_back([&, i]() {
+            lines[i] = parseActionChunk(bounds[i], bounds[i + 1], result.perThread[i]);
+            });
+    }
+    lines[0] = parseActionChunk(bounds[0], bounds[1], result.perThread[0]);
+    for (auto& t : workers) {
+        t.join();
+    }
+
+    for (std::size_t n : lines) result.lines += n;
+    result.bytes = file.size();
+    result.ok = true;
+    return result;
+}
+
+bool writeBinaryActions(const std::string& filename, const std::vector<BinaryAction>& actions) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open file " << filename << " for writing\n";
+        return false;
+    }
+
+    BinaryActionHeader header{};
+    std::memcpy(header.magic, binaryActionMagic, sizeof(header.magic));
+    header.count = std::uint32_t(actions.size());
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(actions.data()), std::streamsize(actions.size() * sizeof(BinaryAction)));
+    return bool(file);
+}
+
+// перетворює текстовий файл дій (actions*.txt, a1..c3.txt) у бінарний
+bool compileActionFile(const std::string& textFile, const std::string& binaryFile,
+    int threads = int(std::thread::hardware_concurrency())) {
+    ParsedTrace trace = parseActionTraceParallel(textFile, threads);
+    if (!trace.ok) return false;
+
+    std::vector<BinaryAction> actions;
+    for (auto& part : trace.perThread) {
+        actions.insert(actions.end(), part.begin(), part.end());
+    }
+
+    return writeBinaryActions(binaryFile, actions);
+}
+
+// профіль навантаження для генератора: частки read / write / string (нормуються)
+// і розподіл індексу — рівномірний (zipfSkew = 0), Zipf з показником zipfSkew
+// або явні ваги полів fieldWeights (тоді fieldCount = fieldWeights.size())
+struct ActionProfile {
+    std::string name;
+    int fieldCount = 3;
+    double readShare = 0.6;
+    double writeShare = 0.25;
+    double snapshotShare = 0.15;
+    double zipfSkew = 0;
+    std::vector<double> fieldWeights;
+};
+
+// генерує totalActions дій за профілем одразу у бінарний формат.
+// Ранги Zipf відображаються на поля випадковою перестановкою, щоб "гарячі"
+// поля не лежали підряд і не потрапляли штучно в одну смугу.
+bool generateActionProfile(const std::string& filename, std::size_t totalActions,
+    const ActionProfile& profile, unsigned seed) {
+    bool weighted = !profile.fieldWeights.empty();
+    int n = weighted ? int(profile.fieldWeights.size()) : std::max(profile.fieldCount, 1);
+    std::mt19937_64 generator(seed);
+
+    std::vector<double> cdf(n);
+    double sum = 0;
+    for (int k = 0; k < n; ++k) {
+        if (weighted) sum += profile.fieldWeights[k];
+        else sum += profile.zipfSkew > 0 ? 1.0 / std::pow(double(k + 1), profile.zipfSkew) : 1.0;
+        cdf[k] = sum;
+    }
+
+    std::vector<int> fieldOfRank(n);
+    for (int k = 0; k < n; ++k) fieldOfRank[k] = k;
+    if (!weighted) std::shuffle(fieldOfRank.begin(), fieldOfRank.end(), generator);
+
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> valueDist(1, 100);
+    std::discrete_distribution<int> opDist({ profile.readShare, profile.writeShare, profile.snapshotShare });
+
+    std::vector<BinaryAction> actions(totalActions);
+    for (auto& action : actions) {
+        action.opcode = Opcode(opDist(generator));
+        if (action.opcode != Opcode::string) {
+            std::size_t rank = std::size_t(std::lower_bound(cdf.begin(), cdf.end(), unit(generator) * sum) - cdf.begin());
+            action.index = fieldOfRank[std::min<std::size_t>(rank, n - 1)];
+        }
+        if (action.opcode == Opcode::write) {
+            action.value = valueDist(generator);
+        }
+    }
+
+    return writeBinaryActions(filename, actions);
+}
+
+// бінарний файл дій, відображений у пам'ять лише для читання
+class MappedActionFile {
+public:
+    explicit MappedActionFile(const std::string& path) : file(path) {
+        if (file.is_open() && file.size() >= sizeof(BinaryActionHeader)) validate();
+    }
+
+    bool is_open() const { return valid; }
+
+    const BinaryAction* begin() const { return actions; }
+    const BinaryAction* end() const { return actions + count; }
+    std::size_t size() const { return count; }
+
+private:
+    // перевіряємо заголовок, розмір і всі коди операцій один раз при відкритті,
+    // щоб таблиця переходів у циклі відтворення не потребувала перевірок
+    void validate() {
+        BinaryActionHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, binaryActionMagic, sizeof(header.magic)) != 0) return;
+        if (file.size() != sizeof(header) + std::size_t(header.count) * sizeof(BinaryAction)) return;
+
+        const BinaryAction* first = reinterpret_cast<const BinaryAction*>(file.data() + sizeof(header));
+        for (std::size_t i = 0; i < header.count; ++i) {
+            if (first[i].opcode >= Opcode::count) return;
+        }
+
+        actions = first;
+        count = header.count;
+        valid = true;
+    }
+
+    MappedFile file;
+    const BinaryAction* actions = nullptr;
+    std::size_t count = 0;
+    bool valid = false;
+};
+
+// обробники дій для таблиці переходів; результат read / to_string лише "споживається"
+template <typename Data>
+void replayRead(Data& data, const BinaryAction& action) {
+    bench::do_not_optimize(data.read(action.index));
+}
+
+template <typename Data>
+void replayWrite(Data& data, const BinaryAction& action) {
+    data.write(action.index, action.value);
+}
+
+template <typename Data>
+void replayString(Data& data, const BinaryAction&) {
+    thread_local std::string buffer;   // після перших викликів уже не алокує
+    data.to_string(buffer);
+    bench::do_not_optimize(buffer.data());
+}
+
+template <typename Data>
+using ReplayHandler = void (*)(Data&, const BinaryAction&);
+
+template <typename Data>
+inline constexpr ReplayHandler<Data> replayTable[std::size_t(Opcode::count)] = {
+    &replayRead<Data>, &replayWrite<Data>, &replayString<Data>
+};
+
+// відтворення без розбору: код операції — індекс у таблиці обробників
+template <typename Data>
+void replayActions(Data& data, const BinaryAction* first, const BinaryAction* last) {
+    for (; first != last; ++first) {
+        replayTable<Data>[std::size_t(first->opcode)](data, *first);
+    }
+}
+
+// те саме із заміром затримки кожної дії в гістограму її типу (perOp[opcode]);
+// кінець однієї дії — початок наступної, тож на дію припадає один виклик годинника
+template <typename Data>
+void replayActionsTimed(Data& data, const BinaryAction* first, const BinaryAction* last,
+    bench::LatencyHistogram* perOp) {
+    using clock = std::chrono::steady_clock;
+
+    auto before = clock::now();
+    for (; first != last; ++first) {
+        replayTable<Data>[std::size_t(first->opcode)](data, *first);
+
+        auto after = clock::now();
+        perOp[std::size_t(first->opcode)].record(
+            std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count()));
+        before = after;
+    }
+}
+
 // вимірювання часу виконання послідовності дій з файлу
-// (час зчитування файлу можна винести окремо, але тут хоч базово є замір алгоритму)
-void measureExecutionTime(MultiThreadedData& data, const std::string& filename) {
+// (файл читається наперед, замір — через bench::run: прогрів + серія вибірок)
+template <typename Data>
+void measureExecutionTime(Data& data, const std::string& filename, int threads = 1, int cpu = -1) {
     // читаємо файл наперед, щоб (хоч приблизно) не враховувати IO у замір
     std::ifstream actionFile(filename);
     if (!actionFile.is_open()) {
@@ -139,63 +1234,452 @@ void measureExecutionTime(MultiThreadedData& data, const std::string& filename)
     }
     actionFile.close();
 
-    auto start = std::chrono::high_resolution_clock::now();
+    bench::Options options;
+    options.pin_cpu = cpu;
 
-    for (const auto& l : lines) {
-        std::istringstream iss(l);
-        std::string command;
-        int index, value;
+    std::string name = std::string(Data::name) + "/threads=" + std::to_string(threads) + "/" + filename;
 
-        if (!(iss >> command))
-            continue;
+    // промахи кешу цього потоку за всі прогони (прогрів + вибірки)
+    bench::CacheMissCounter cacheMisses;
+    cacheMisses.start();
 
-        if (command == "write") {
-            if (iss >> index >> value) {
-                data.write(index, value);
+    bench::Stats stats = bench::run(name, [&]() {
+        for (const auto& l : lines) {
+            std::istringstream iss(l);
+            std::string command;
+            int index, value;
+
+            if (!(iss >> command))
+                continue;
+
+            if (command == "write") {
+                if (iss >> index >> value) {
+                    data.write(index, value);
+                }
+            }
+            else if (command == "read") {
+                if (iss >> index) {
+                    bench::do_not_optimize(data.read(index)); // без друку, але й без викидання компілятором
+                }
+            }
+            else if (command == "string") {
+                bench::do_not_optimize(data.to_string()); // теж без друку, щоб не спотворювати час
             }
         }
-        else if (command == "read") {
-            if (iss >> index) {
-                data.read(index); // для замірів достатньо читання, можна не друкувати
+        }, options);
+
+    long long misses = cacheMisses.stop();
+    double opsPerSecond = stats.median > 0 ? lines.size() / (stats.median / 1000.0) : 0;
+
+    std::ostringstream report;
+    report << "Execution time for " << filename
+        << " [" << Data::name << "]: " << stats
+        << ", " << static_cast<long long>(opsPerSecond) << " ops/s, cache misses/replay: ";
+    if (misses >= 0) {
+        report << misses / static_cast<long long>(options.warmup + options.samples);
+    }
+    else {
+        report << "n/a";
+    }
+    std::cout << report.str() << '\n';
+}
+
+// те саме, але для бінарного файлу дій: у замір потрапляє лише робота зі структурою.
+// flushCount > 0 — записи йдуть через WriteCombiner з такою кількістю записів на пакет
+template <typename Data>
+void measureBinaryExecutionTime(Data& data, const std::string& filename, int threads = 1, int cpu = -1,
+    std::size_t flushCount = 0) {
+    MappedActionFile actions(filename);
+    if (!actions.is_open()) {
+        std::cerr << "Unable to map binary action file: " << filename << std::endl;
+        return;
+    }
+
+    bench::Options options;
+    options.pin_cpu = cpu;
+    // короткі файли (a1..c3 — по 1000 дій) повторюємо, щоб вибірка тривала хоча б ~1 мс
+    options.iterations = std::max<std::size_t>(1, 100000 / std::max<std::size_t>(actions.size(), 1));
+
+    std::string mode = flushCount > 0 ? "binary/batch=" + std::to_string(flushCount) : "binary";
+    std::string name = std::string(Data::name) + "/" + mode + "/threads=" + std::to_string(threads) + "/" + filename;
+
+    bench::CacheMissCounter cacheMisses;
+    cacheMisses.start();
+
+    bench::Stats stats = bench::run(name, [&]() {
+        if (flushCount > 0) {
+            WriteCombiner<Data> combiner(data, { flushCount });
+            replayActions(combiner, actions.begin(), actions.end());
+        }
+        else {
+            replayActions(data, actions.begin(), actions.end());
+        }
+        }, options);
+
+    long long misses = cacheMisses.stop();
+    double opsPerSecond = stats.median > 0 ? actions.size() / (stats.median / 1000.0) : 0;
+
+    std::ostringstream report;
+    report << "Execution time for " << filename
+        << " [" << Data::name << ", " << mode << "]: " << stats
+        << ", " << static_cast<long long>(opsPerSecond) << " ops/s, cache misses/replay: ";
+    if (misses >= 0) {
+        report << misses / static_cast<long long>((options.warmup + options.samples) * options.iterations);
+    }
+    else {
+        report << "n/a";
+    }
+    std::cout << report.str() << '\n';
+}
+
+// набори a/b/c: три потоки одночасно відтворюють x1, x2, x3 над спільною структурою —
+// спершу із захопленням м'ютекса на кожен запис, потім пакетами по 4 / 16 / 64 записи
+template <typename Data>
+void runWriteCombiningScenarios() {
+    std::cout << "\n##### write combining, backend: " << Data::name << " #####\n";
+
+    for (const char* group : { "a", "b", "c" }) {
+        for (std::size_t flushCount : { std::size_t(0), std::size_t(4), std::size_t(16), std::size_t(64) }) {
+            Data data;
+
+            std::cout << "\n=== " << group << "1.." << group << "3, "
+                << (flushCount > 0 ? "batch=" + std::to_string(flushCount) : std::string("per-call")) << " ===\n";
+
+            std::vector<std::thread> workers;
+            for (int i = 0; i < 3; ++i) {
+                std::string file = std::string(group) + std::to_string(i + 1) + ".bin";
+                workers.emplace_back(measureBinaryExecutionTime<Data>, std::ref(data), file, 3, i, flushCount);
+            }
+            for (auto& t : workers) {
+                t.join();
             }
         }
-        else if (command == "string") {
-            data.to_string(); // теж без друку, щоб не спотворювати час
+    }
+}
+
+// план відтворення: для кожного потоку — список бінарних файлів, які він відтворює підряд
+using ReplayPlan = std::vector<std::vector<std::string>>;
+
+struct ReplayResult {
+    std::string backend;
+    std::string plan;
+    int threads = 0;
+    std::size_t ops = 0;
+    double seconds = 0;
+    std::vector<bench::LatencyHistogram> perOp;   // по гістограмі на кожен Opcode
+};
+
+// запускає plan.size() потоків над однією структурою Data; кожен відображає свої файли
+// в пам'ять заздалегідь, потім усі стартують разом після бар'єра й rounds разів
+// відтворюють свої файли. Час — від найранішого старту до найпізнішого завершення.
+template <typename Data>
+ReplayResult runReplayDriver(const std::string& planName, const ReplayPlan& plan, int rounds = 5) {
+    int threads = int(plan.size());
+    Data data;
+
+    ReplayResult result;
+    result.backend = Data::name;
+    result.plan = planName;
+    result.threads = threads;
+    result.perOp.resize(std::size_t(Opcode::count));
+
+    std::vector<std::vector<bench::LatencyHistogram>> histograms(threads,
+        std::vector<bench::LatencyHistogram>(std::size_t(Opcode::count)));
+    std::vector<std::size_t> ops(threads, 0);
+    std::vector<std::chrono::steady_clock::time_point> starts(threads), ends(threads);
+    std::barrier startLine(threads);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            bench::pin_current_thread(t);
+
+            std::vector<std::unique_ptr<MappedActionFile>> traces;
+            for (const auto& file : plan[t]) {
+                traces.push_back(std::make_unique<MappedActionFile>(file));
+                if (!traces.back()->is_open()) {
+                    std::cerr << "Unable to map binary action file: " << file << std::endl;
+                    traces.pop_back();
+                }
+            }
+
+            startLine.arrive_and_wait();
+            starts[t] = std::chrono::steady_clock::now();
+
+            for (int r = 0; r < rounds; ++r) {
+                for (const auto& trace : traces) {
+                    replayActionsTimed(data, trace->begin(), trace->end(), histograms[t].data());
+                    ops[t] += trace->size();
+                }
+            }
+
+            ends[t] = std::chrono::steady_clock::now();
+            });
+    }
+    for (auto& t : workers) {
+        t.join();
+    }
+
+    for (int t = 0; t < threads; ++t) {
+        result.ops += ops[t];
+        for (std::size_t op = 0; op < std::size_t(Opcode::count); ++op) {
+            result.perOp[op].merge(histograms[t][op]);
         }
     }
+    if (threads > 0) {
+        auto first = *std::min_element(starts.begin(), starts.end());
+        auto last = *std::max_element(ends.begin(), ends.end());
+        result.seconds = std::chrono::duration<double>(last - first).count();
+    }
 
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> duration = end - start;
+    static const char* opNames[] = { "read", "write", "string" };
 
-    std::cout << "Execution time for " << filename
-        << ": " << duration.count() << " seconds\n";
+    std::cout << "[" << result.backend << "] " << planName << ", threads=" << threads
+        << ": " << result.ops << " ops in " << result.seconds * 1000 << " ms, "
+        << static_cast<long long>(result.seconds > 0 ? result.ops / result.seconds : 0) << " ops/s\n";
+    for (std::size_t op = 0; op < std::size_t(Opcode::count); ++op) {
+        const auto& h = result.perOp[op];
+        if (h.count() == 0) continue;
+        std::cout << "    " << opNames[op] << ": n=" << h.count()
+            << ", p50 " << h.percentile(0.50) << " ns, p99 " << h.percentile(0.99)
+            << " ns, p999 " << h.percentile(0.999) << " ns, max " << h.max() << " ns\n";
+    }
+    return result;
 }
 
-int main() {
-    // спільна структура даних, по якій працюють усі потоки
-    MultiThreadedData data;
+// усі прогони драйвера в один CSV: по рядку на (бекенд, план, тип дії)
+bool writeReplayCsv(const std::string& path, const std::vector<ReplayResult>& results) {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    static const char* opNames[] = { "read", "write", "string" };
+
+    file << "backend,plan,threads,op,count,total_ops_per_s,p50_ns,p99_ns,p999_ns,max_ns\n";
+    for (const auto& r : results) {
+        for (std::size_t op = 0; op < r.perOp.size(); ++op) {
+            const auto& h = r.perOp[op];
+            file << r.backend << ',' << r.plan << ',' << r.threads << ',' << opNames[op] << ','
+                << h.count() << ',' << (r.seconds > 0 ? r.ops / r.seconds : 0) << ','
+                << h.percentile(0.50) << ',' << h.percentile(0.99) << ','
+                << h.percentile(0.999) << ',' << h.max() << '\n';
+        }
+    }
+    return true;
+}
+
+// масштабування: 1..maxThreads потоків над actions{t % 3 + 1}.bin, а також набори a/b/c —
+// по потоку на кожен файл a1..c3 і по потоку на кожну групу (a1 a2 a3 підряд тощо)
+template <typename Data>
+void runReplayPlans(int maxThreads, std::vector<ReplayResult>& results) {
+    std::cout << "\n##### replay driver, backend: " << Data::name << " #####\n";
+
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        ReplayPlan plan(threads);
+        for (int t = 0; t < threads; ++t) {
+            plan[t] = { "actions" + std::to_string(t % 3 + 1) + ".bin" };
+        }
+        results.push_back(runReplayDriver<Data>("actions", plan));
+    }
+
+    ReplayPlan perFile, perGroup;
+    for (const char* group : { "a", "b", "c" }) {
+        perGroup.emplace_back();
+        for (int i = 1; i <= 3; ++i) {
+            std::string file = std::string(group) + std::to_string(i) + ".bin";
+            perFile.push_back({ file });
+            perGroup.back().push_back(file);
+        }
+    }
+    results.push_back(runReplayDriver<Data>("abc-per-file", perFile, 100));
+    results.push_back(runReplayDriver<Data>("abc-per-group", perGroup, 100));
+}
+
+// швидкість паралельного розбору великого текстового файлу: рядки / с і МБ / с
+// для 1, 2, ... maxThreads потоків (час включає mmap і поділ на шматки)
+void measureParseThroughput(const std::string& filename, int maxThreads) {
+    std::cout << "\n##### parallel parse: " << filename << " #####\n";
+
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        ParsedTrace trace;
+        bench::Options options;
+        options.warmup = 1;
+        options.samples = 5;
+
+        bench::Stats stats = bench::run("parse/threads=" + std::to_string(threads) + "/" + filename, [&]() {
+            trace = parseActionTraceParallel(filename, threads);
+            bench::do_not_optimize(trace.lines);
+            }, options);
+
+        if (!trace.ok) return;
+
+        double seconds = stats.median / 1000.0;
+        std::cout << "threads=" << threads << ": " << stats
+            << ", " << static_cast<long long>(trace.lines / seconds) << " lines/s, "
+            << trace.bytes / seconds / (1 << 20) << " MiB/s\n";
+    }
+}
+
+// перебір кількості смуг для заданого профілю: threads потоків одночасно
+// відтворюють свої файли над одним сховищем; повідомляється найкраща кількість смуг
+void runStripeSweep(const ActionProfile& profile, int threads, std::size_t actionsPerThread) {
+    std::cout << "\n##### stripe sweep: " << profile.name << ", fields=" << profile.fieldCount
+        << ", threads=" << threads << " #####\n";
+
+    std::vector<std::string> files;
+    for (int i = 0; i < threads; ++i) {
+        files.push_back("profile_" + profile.name + "_" + std::to_string(i) + ".bin");
+        generateActionProfile(files.back(), actionsPerThread, profile, 1000u + unsigned(i));
+    }
+
+    std::vector<std::unique_ptr<MappedActionFile>> traces;
+    for (const auto& file : files) {
+        traces.push_back(std::make_unique<MappedActionFile>(file));
+        if (!traces.back()->is_open()) {
+            std::cerr << "Unable to map binary action file: " << file << std::endl;
+            return;
+        }
+    }
+
+    bench::Options options;
+    options.warmup = 1;
+    options.samples = 5;
+
+    std::size_t bestStripes = 0;
+    double bestOps = 0;
+
+    for (std::size_t stripes = 1; stripes <= std::size_t(profile.fieldCount); stripes *= 4) {
+        StripedMultiThreadedData data(profile.fieldCount, stripes);
+
+        std::string name = std::string(StripedMultiThreadedData::name) + "/" + profile.name
+            + "/stripes=" + std::to_string(stripes) + "/threads=" + std::to_string(threads);
+
+        bench::Stats stats = bench::run(name, [&]() {
+            std::vector<std::thread> workers;
+            for (int i = 0; i < threads; ++i) {
+                workers.emplace_back([&, i]() {
+                    bench::pin_current_thread(i);
+                    replayActions(data, traces[i]->begin(), traces[i]->end());
+                    });
+            }
+            for (auto& t : workers) {
+                t.join();
+            }
+            }, options);
+
+        double opsPerSecond = stats.median > 0 ? actionsPerThread * threads / (stats.median / 1000.0) : 0;
+        std::cout << "stripes=" << stripes << ": " << stats << ", "
+            << static_cast<long long>(opsPerSecond) << " ops/s\n";
 
+        if (opsPerSecond > bestOps) {
+            bestOps = opsPerSecond;
+            bestStripes = stripes;
+        }
+    }
+
+    std::cout << "BEST stripes = " << bestStripes << ", " << static_cast<long long>(bestOps) << " ops/s\n";
+}
+
+// сценарії з 1, 2, 3, ... потоками над однією спільною структурою типу Data;
+// потік i виконує actions{i % 3 + 1}.txt (або .bin при binary) і прив'язаний до ядра i
+template <typename Data>
+void runThreadScenarios(int maxThreads, bool binary = true) {
+    static const char* textFiles[] = { "actions1.txt", "actions2.txt", "actions3.txt" };
+    static const char* binaryFiles[] = { "actions1.bin", "actions2.bin", "actions3.bin" };
+
+    std::cout << "\n##### backend: " << Data::name << (binary ? ", binary replay" : ", text replay") << " #####\n";
+
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        // спільна структура даних, по якій працюють усі потоки сценарію
+        Data data;
+
+        std::cout << "\n=== " << threads << (threads == 1 ? " thread" : " threads") << " ===\n";
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i) {
+            if (binary) {
+                workers.emplace_back(measureBinaryExecutionTime<Data>, std::ref(data), binaryFiles[i % 3], threads, i, std::size_t(0));
+            }
+            else {
+                workers.emplace_back(measureExecutionTime<Data>, std::ref(data), textFiles[i % 3], threads, i);
+            }
+        }
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+}
+
+int main() {
     // генеруємо три файли з діями (тут поки всі – з частотами варіанта №9)
     generateActionSequence("actions1.txt", 100000);
     generateActionSequence("actions2.txt", 100000);
     generateActionSequence("actions3.txt", 100000);
 
-    std::cout << "=== 1 thread ===\n";
-    measureExecutionTime(data, "actions1.txt");
-
-    std::cout << "\n=== 2 threads ===\n";
-    std::thread t1(measureExecutionTime, std::ref(data), "actions2.txt");
-    std::thread t2(measureExecutionTime, std::ref(data), "actions3.txt");
-    t1.join();
-    t2.join();
-
-    std::cout << "\n=== 3 threads ===\n";
-    std::thread t3(measureExecutionTime, std::ref(data), "actions1.txt");
-    std::thread t4(measureExecutionTime, std::ref(data), "actions2.txt");
-    std::thread t5(measureExecutionTime, std::ref(data), "actions3.txt");
-    t3.join();
-    t4.join();
-    t5.join();
+    // великий файл для заміру швидкості розбору
+    generateActionSequence("actions_big.txt", 4000000);
+
+    // бінарні копії: і згенерованих файлів, і наборів a1..c3 з репозиторію
+    static const char* traces[] = {
+        "actions1", "actions2", "actions3",
+        "a1", "a2", "a3", "b1", "b2", "b3", "c1", "c2", "c3"
+    };
+    for (const char* trace : traces) {
+        compileActionFile(std::string(trace) + ".txt", std::string(trace) + ".bin");
+    }
+
+    // 1, 2, 3 потоки, як і раніше, а на машинах з більшою кількістю ядер — і далі
+    int maxThreads = std::max(3, int(std::thread::hardware_concurrency()));
+
+    measureParseThroughput("actions_big.txt", maxThreads);
+
+    // текстове відтворення лишаємо лише для порівняння вартості розбору рядків
+    runThreadScenarios<MultiThreadedData>(maxThreads, false);
+    runThreadScenarios<MultiThreadedData>(maxThreads);
+    runThreadScenarios<PaddedMultiThreadedData>(maxThreads);
+    runThreadScenarios<AtomicMultiThreadedData>(maxThreads);
+    runThreadScenarios<PaddedAtomicMultiThreadedData>(maxThreads);
+    runThreadScenarios<SeqlockMultiThreadedData>(maxThreads);
+
+    // сховище на багато полів: рівномірний доступ, Zipf і кілька дуже "гарячих" полів
+    runStripeSweep({ "uniform", 1 << 16, 0.75, 0.25, 0.0, 0.0, {} }, maxThreads, 200000);
+    runStripeSweep({ "zipf", 1 << 16, 0.75, 0.25, 0.0, 0.99, {} }, maxThreads, 200000);
+    runStripeSweep({ "hot", 1024, 0.5, 0.499, 0.001, 1.2, {} }, maxThreads, 200000);
+
+    // набори a1..c3 — по одному потоку, бінарне відтворення
+    std::cout << "\n##### trace files, backend: " << MultiThreadedData::name << " #####\n";
+    for (int i = 3; i < 12; ++i) {
+        MultiThreadedData data;
+        measureBinaryExecutionTime(data, std::string(traces[i]) + ".bin");
+    }
+
+    // пакетний запис проти захоплення м'ютекса на кожен write
+    runWriteCombiningScenarios<MultiThreadedData>();
+    runWriteCombiningScenarios<SeqlockMultiThreadedData>();
+
+    // драйвер відтворення: гістограми затримок за типами дій і ops/s
+    std::vector<ReplayResult> replayResults;
+    runReplayPlans<MultiThreadedData>(maxThreads, replayResults);
+    runReplayPlans<AtomicMultiThreadedData>(maxThreads, replayResults);
+    runReplayPlans<SeqlockMultiThreadedData>(maxThreads, replayResults);
+
+    // великі записи, навантаження з переважним читанням поля 2: м'ютекс проти RCU
+    static const ActionProfile field2ReadHeavy{ "field2", 3, 0.9, 0.1, 0.0, 0.0, { 0.1, 0.1, 0.8 } };
+    std::cout << "\n##### large records, read-heavy field 2 #####\n";
+    for (int t = 0; t < maxThreads; ++t) {
+        generateActionProfile("field2_" + std::to_string(t) + ".bin", 200000, field2ReadHeavy, 2000u + unsigned(t));
+    }
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        ReplayPlan plan(threads);
+        for (int t = 0; t < threads; ++t) plan[t] = { "field2_" + std::to_string(t) + ".bin" };
+        replayResults.push_back(runReplayDriver<LargeRecordMutexData>("field2", plan));
+        replayResults.push_back(runReplayDriver<RcuMultiThreadedData>("field2", plan));
+    }
+
+    writeReplayCsv("replay_results.csv", replayResults);
+
+    // усі заміри процесу — у CSV / JSON для відстеження регресій
+    bench::default_report().write_csv("bench_results.csv");
+    bench::default_report().write_json("bench_results.json");
 
     return 0;
 }
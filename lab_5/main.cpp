@@ -2,8 +2,28 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <future>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <variant>
+#include <mutex>
+#include <stdexcept>
 #include <syncstream>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../common/bench.h"
+#include "../common/trace.h"
 
 //  
 using namespace std::chrono_literals;
@@ -11,61 +31,802 @@ using namespace std::chrono_literals;
 //  "" 
 void compute(const std::string& name, int seconds)
 {
+    //    -      ( osyncstream);
+    //      (print_completed)
+    trace::Scope scope(name, seconds);
+
     //   
     std::this_thread::sleep_for(std::chrono::seconds(seconds));
+}
+
+//  ,     since_ns,   
+void print_completed(uint64_t since_ns)
+{
+    auto events = trace::collector().events();
+    std::stable_sort(events.begin(), events.end(), [](const trace::Event& a, const trace::Event& b) {
+        return a.start_ns + a.duration_ns < b.start_ns + b.duration_ns;
+    });
 
-    //  
     std::osyncstream out(std::cout);
-    out << name << '\n';
+    for (const auto& e : events) {
+        if (e.start_ns >= since_ns) out << e.name << '\n';
+    }
 }
 
+constexpr int slow_seconds = 7;
+constexpr int quick_seconds = 1;
+
 // "" : 7 
 inline void slow(const std::string& name)
 {
-    compute(name, 7);
+    compute(name, slow_seconds);
 }
 
 // "" : 1 
 inline void quick(const std::string& name)
 {
-    compute(name, 1);
+    compute(name, quick_seconds);
 }
 
 
-void work()
+//  :  = ,  ,   ,    .
+//        ,    ,
+//    - .
+//       :
+//  - run(workers):   ,     ,
+//          ( FIFO);
+//  - run(plan(workers)):      
+//    (HEFT:    upward rank,  -  ,   ),
+//            .
+//          
+// (plan / simulate),       .
+class TaskGraph
 {
-    using clock = std::chrono::steady_clock;
-    auto t_start = clock::now();
+public:
+    using TaskId = size_t;
+
+    //    : ,     
+    struct Schedule
+    {
+        int workers = 0;
+        std::vector<int> worker;
+        std::vector<double> start;
+        std::vector<double> finish;
+        std::vector<std::vector<TaskId>> order;   //    
+        double makespan = 0;
+    };
+
+    TaskId add(std::string name, double cost, std::function<void()> action, std::vector<TaskId> deps = {})
+    {
+        TaskId id = tasks.size();
+        for (TaskId d : deps) {
+            if (d >= id) throw std::invalid_argument("dependency on unknown task for " + name);
+        }
+        tasks.push_back({std::move(name), cost, std::move(action), std::move(deps), {}});
+        for (TaskId d : tasks.back().deps) tasks[d].successors.push_back(id);
+        return id;
+    }
+
+    size_t size() const { return tasks.size(); }
+    const std::string& name(TaskId id) const { return tasks[id].name; }
+
+    double total_cost() const
+    {
+        double total = 0;
+        for (const auto& t : tasks) total += t.cost;
+        return total;
+    }
+
+    //       :     
+    double critical_path() const
+    {
+        std::vector<double> finish(tasks.size(), 0);
+        double result = 0;
+        for (TaskId id = 0; id < tasks.size(); ++id) {
+            double start = 0;
+            for (TaskId d : tasks[id].deps) start = std::max(start, finish[d]);
+            finish[id] = start + tasks[id].cost;
+            result = std::max(result, finish[id]);
+        }
+        return result;
+    }
+
+    // upward rank:   +       
+    std::vector<double> upward_rank() const
+    {
+        std::vector<double> rank(tasks.size(), 0);
+        for (TaskId id = tasks.size(); id-- > 0;) {
+            double tail = 0;
+            for (TaskId s : tasks[id].successors) tail = std::max(tail, rank[s]);
+            rank[id] = tasks[id].cost + tail;
+        }
+        return rank;
+    }
+
+    // HEFT        :    rank
+    // (  rank -   ,    ),
+    //      ,     
+    Schedule plan(int workers) const
+    {
+        Schedule s = empty_schedule(workers);
+        auto rank = upward_rank();
+
+        std::vector<TaskId> order(tasks.size());
+        for (TaskId id = 0; id < tasks.size(); ++id) order[id] = id;
+        std::stable_sort(order.begin(), order.end(), [&](TaskId a, TaskId b) { return rank[a] > rank[b]; });
+
+        std::vector<double> available(s.workers, 0);
+        for (TaskId id : order) {
+            double ready_at = 0;
+            for (TaskId d : tasks[id].deps) ready_at = std::max(ready_at, s.finish[d]);
+
+            int best = 0;
+            for (int w = 1; w < s.workers; ++w) {
+                if (std::max(available[w], ready_at) < std::max(available[best], ready_at)) best = w;
+            }
+            place(s, id, best, std::max(available[best], ready_at));
+            available[best] = s.finish[id];
+        }
+        return s;
+    }
+
+    //  ,   run(workers),        
+    Schedule simulate(int workers) const
+    {
+        Schedule s = empty_schedule(workers);
+
+        std::vector<size_t> waiting(tasks.size());
+        std::deque<TaskId> queue;
+        for (TaskId id = 0; id < tasks.size(); ++id) {
+            waiting[id] = tasks[id].deps.size();
+            if (waiting[id] == 0) queue.push_back(id);
+        }
+
+        // running[w] -    w  tasks.size(),   
+        std::vector<TaskId> running(s.workers, tasks.size());
+        double now = 0;
+        size_t done = 0;
+        while (done < tasks.size()) {
+            for (int w = 0; w < s.workers && !queue.empty(); ++w) {
+                if (running[w] != tasks.size()) continue;
+                running[w] = queue.front();
+                queue.pop_front();
+                place(s, running[w], w, now);
+            }
+
+            //   -     
+            int next = -1;
+            for (int w = 0; w < s.workers; ++w) {
+                if (running[w] == tasks.size()) continue;
+                if (next < 0 || s.finish[running[w]] < s.finish[running[next]]) next = w;
+            }
+            TaskId id = running[next];
+            now = s.finish[id];
+            running[next] = tasks.size();
+            ++done;
+            for (TaskId succ : tasks[id].successors) {
+                if (--waiting[succ] == 0) queue.push_back(succ);
+            }
+        }
+        return s;
+    }
+
+    //     workers ;    - 
+    //          
+    void run(int workers)
+    {
+        reset();
+        for (TaskId id = 0; id < tasks.size(); ++id) {
+            if (pending[id] == 0) ready.push_back(id);
+        }
+
+        std::vector<std::thread> pool;
+        for (int i = 0; i < std::max(1, workers); ++i) {
+            pool.emplace_back(&TaskGraph::worker, this);
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    //   :  w       ,
+    //       
+    void run(const Schedule& schedule)
+    {
+        reset();
+
+        std::vector<std::thread> pool;
+        for (const auto& queue : schedule.order) {
+            pool.emplace_back(&TaskGraph::planned_worker, this, std::cref(queue));
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    struct Task
+    {
+        std::string name;
+        double cost;
+        std::function<void()> action;
+        std::vector<TaskId> deps;
+        std::vector<TaskId> successors;
+    };
+
+    Schedule empty_schedule(int workers) const
+    {
+        Schedule s;
+        s.workers = std::max(1, workers);
+        s.worker.assign(tasks.size(), -1);
+        s.start.assign(tasks.size(), 0);
+        s.finish.assign(tasks.size(), 0);
+        s.order.resize(s.workers);
+        return s;
+    }
+
+    void place(Schedule& s, TaskId id, int w, double start) const
+    {
+        s.worker[id] = w;
+        s.start[id] = start;
+        s.finish[id] = start + tasks[id].cost;
+        s.order[w].push_back(id);
+        s.makespan = std::max(s.makespan, s.finish[id]);
+    }
+
+    void reset()
+    {
+        pending.assign(tasks.size(), 0);
+        ready.clear();
+        remaining = tasks.size();
+        error = nullptr;
+        for (TaskId id = 0; id < tasks.size(); ++id) pending[id] = tasks[id].deps.size();
+    }
+
+    //       ; false -   
+    bool execute(TaskId id, std::unique_lock<std::mutex>& lock)
+    {
+        lock.unlock();
+        std::exception_ptr failure;
+        try {
+            tasks[id].action();
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        lock.lock();
+
+        if (failure) {
+            if (!error) error = failure;
+            cv.notify_all();
+            return false;
+        }
+
+        --remaining;
+        for (TaskId s : tasks[id].successors) {
+            if (--pending[s] == 0) ready.push_back(s);
+        }
+        cv.notify_all();
+        return true;
+    }
+
+    void worker()
+    {
+        std::unique_lock<std::mutex> lock(m);
+        while (true) {
+            cv.wait(lock, [&] { return !ready.empty() || remaining == 0 || error; });
+            if (remaining == 0 || error) return;
+
+            TaskId id = ready.front();
+            ready.pop_front();
+            if (!execute(id, lock)) return;
+        }
+    }
+
+    void planned_worker(const std::vector<TaskId>& queue)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        for (TaskId id : queue) {
+            cv.wait(lock, [&] { return pending[id] == 0 || error; });
+            if (error) return;
+            if (!execute(id, lock)) return;
+        }
+    }
+
+    std::vector<Task> tasks;
+
+    std::mutex m;   // pending, ready, remaining, error
+    std::condition_variable cv;
+    std::vector<size_t> pending;
+    std::deque<TaskId> ready;
+    size_t remaining = 0;
+    std::exception_ptr error;
+};
+
+
+// -----------------  ̲ future::get -----------------
+// std::async + get()        '.
+//  future/promise  : then()  when_all()   ,
+//     ,     , -   
+//  ;  get()     ,   .
+
+//      ;     
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threads)
+    {
+        for (int i = 0; i < std::max(1, threads); ++i) {
+            workers.emplace_back([this] { loop(); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            jobs.push_back(std::move(job));
+        }
+        cv.notify_one();
+    }
+
+private:
+    void loop()
+    {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [&] { return !jobs.empty() || stopping; });
+                if (jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> jobs;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+};
+
+//  Future<void>   
+template <typename T>
+using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+template <typename T>
+struct SharedState
+{
+    std::mutex m;
+    std::condition_variable cv;   //   get()
+    bool ready = false;
+    std::optional<Stored<T>> value;
+    std::exception_ptr error;
+    std::vector<std::function<void()>> continuations;
+
+    //    ;     
+    void complete(std::optional<Stored<T>> v, std::exception_ptr e)
+    {
+        std::vector<std::function<void()>> pending;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            value = std::move(v);
+            error = e;
+            ready = true;
+            pending.swap(continuations);
+        }
+        cv.notify_all();
+        for (auto& c : pending) c();
+    }
+};
+
+//  f(args...)    ( )  state
+template <typename R, typename F, typename... Args>
+void fulfill(SharedState<R>& state, F& f, Args&&... args)
+{
+    try {
+        if constexpr (std::is_void_v<R>) {
+            f(std::forward<Args>(args)...);
+            state.complete(std::monostate{}, nullptr);
+        } else {
+            state.complete(f(std::forward<Args>(args)...), nullptr);
+        }
+    } catch (...) {
+        state.complete(std::nullopt, std::current_exception());
+    }
+}
 
-    //  : C2,  D2
-    auto fut = std::async(std::launch::async, [] {
-        quick("C2");   //    
-        quick("D2");   //    ,    F
+template <typename F, typename T>
+struct ContinuationResult
+{
+    using type = std::invoke_result_t<F&, const T&>;
+};
+
+template <typename F>
+struct ContinuationResult<F, void>
+{
+    using type = std::invoke_result_t<F&>;
+};
+
+template <typename T>
+class Future
+{
+public:
+    Future() = default;
+    explicit Future(std::shared_ptr<SharedState<T>> state) : state(std::move(state)) {}
+
+    // callback   : ,    ,  -  ,
+    //   
+    void on_ready(std::function<void()> callback) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(state->m);
+            if (!state->ready) {
+                state->continuations.push_back(std::move(callback));
+                return;
+            }
+        }
+        callback();
+    }
+
+    // f() ( f()  Future<void>)    pool  ;
+    //       f
+    template <typename F>
+    auto then(ThreadPool& pool, F f) const
+    {
+        using R = typename ContinuationResult<F, T>::type;
+        auto next = std::make_shared<SharedState<R>>();
+        on_ready([source = state, next, &pool, f = std::move(f)]() mutable {
+            pool.submit([source, next, f = std::move(f)]() mutable {
+                if (source->error) {
+                    next->complete(std::nullopt, source->error);
+                } else if constexpr (std::is_void_v<T>) {
+                    fulfill(*next, f);
+                } else {
+                    fulfill(*next, f, std::as_const(*source->value));
+                }
+            });
         });
+        return Future<R>(next);
+    }
 
-    //  :  
-    slow("A");   // , 7 
-    slow("B");   // , 7 , B(A)
-    quick("C1"); // , C1(B)
+    //    -  ,    
+    const Stored<T>& get() const
+    {
+        std::unique_lock<std::mutex> lock(state->m);
+        state->cv.wait(lock, [&] { return state->ready; });
+        if (state->error) std::rethrow_exception(state->error);
+        return *state->value;
+    }
 
-    fut.get();   //   C2  D2
+private:
+    std::shared_ptr<SharedState<T>> state;
+};
 
-    quick("D1"); // D1   C1  C2
-    quick("F");  // F   D1  D2
+template <typename F>
+auto async(ThreadPool& pool, F f)
+{
+    using R = std::invoke_result_t<F&>;
+    auto state = std::make_shared<SharedState<R>>();
+    pool.submit([state, f = std::move(f)]() mutable { fulfill(*state, f); });
+    return Future<R>(state);
+}
+
+// ,    ;  -     ( void - ),
+//      
+template <typename T>
+auto when_all(std::vector<Future<T>> inputs)
+{
+    using R = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+    auto next = std::make_shared<SharedState<R>>();
+    if (inputs.empty()) {
+        if constexpr (std::is_void_v<T>) next->complete(std::monostate{}, nullptr);
+        else next->complete(R{}, nullptr);
+        return Future<R>(next);
+    }
+
+    auto all = std::make_shared<std::vector<Future<T>>>(std::move(inputs));
+    auto left = std::make_shared<std::atomic<size_t>>(all->size());
+    for (const auto& input : *all) {
+        input.on_ready([all, left, next] {
+            if (left->fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    for (const auto& f : *all) f.get();
+                    next->complete(std::monostate{}, nullptr);
+                } else {
+                    R values;
+                    values.reserve(all->size());
+                    for (const auto& f : *all) values.push_back(f.get());
+                    next->complete(std::move(values), nullptr);
+                }
+            } catch (...) {
+                next->complete(std::nullopt, std::current_exception());
+            }
+        });
+    }
+    return Future<R>(next);
+}
+
+template <typename T, typename... Rest>
+auto when_all(Future<T> first, Future<Rest>... rest)
+{
+    return when_all(std::vector<Future<T>>{std::move(first), std::move(rest)...});
+}
+
+
+//  lab_5:  ;       
+void add_work_tasks(TaskGraph& graph)
+{
+    auto A  = graph.add("A",  slow_seconds,  [] { slow("A"); });
+    auto B  = graph.add("B",  slow_seconds,  [] { slow("B"); },   {A});
+    auto C1 = graph.add("C1", quick_seconds, [] { quick("C1"); }, {B});
+    auto C2 = graph.add("C2", quick_seconds, [] { quick("C2"); });
+    auto D1 = graph.add("D1", quick_seconds, [] { quick("D1"); }, {C1, C2});
+    auto D2 = graph.add("D2", quick_seconds, [] { quick("D2"); });
+    graph.add("F", quick_seconds, [] { quick("F"); }, {D1, D2});
+}
+
+using Action = void (*)(const std::string&);
+
+//   :  C2-D2  std::async,     fut.get()
+void graph_async(Action slow_task, Action quick_task)
+{
+    auto fut = std::async(std::launch::async, [=] {
+        quick_task("C2");
+        quick_task("D2");
+        });
+
+    slow_task("A");
+    slow_task("B");   // B(A)
+    quick_task("C1"); // C1(B)
+
+    fut.get();        //   C2  D2
+
+    quick_task("D1"); // D1   C1  C2
+    quick_task("F");  // F   D1  D2
+}
+
+//     : D1  F   ,    
+Future<void> graph_futures(ThreadPool& pool, Action slow_task, Action quick_task)
+{
+    auto A  = async(pool, [=] { slow_task("A"); });
+    auto B  = A.then(pool, [=] { slow_task("B"); });
+    auto C1 = B.then(pool, [=] { quick_task("C1"); });
+    auto C2 = async(pool, [=] { quick_task("C2"); });
+    auto D1 = when_all(C1, C2).then(pool, [=] { quick_task("D1"); });
+    auto D2 = async(pool, [=] { quick_task("D2"); });
+    return when_all(D1, D2).then(pool, [=] { quick_task("F"); });
+}
+
+void print_schedule(const TaskGraph& graph, const TaskGraph::Schedule& s)
+{
+    std::osyncstream out(std::cout);
+    for (int w = 0; w < s.workers; ++w) {
+        out << "  worker " << w << ":";
+        for (auto id : s.order[w]) out << ' ' << graph.name(id) << " [" << s.start[id] << "-" << s.finish[id] << "]";
+        out << '\n';
+    }
+}
+
+// mode: heft -    plan(), dynamic -   run(workers),
+// futures -  then / when_all    workers , async -  std::async + get()
+void work(const std::string& mode, int workers)
+{
+    using clock = std::chrono::steady_clock;
+
+    TaskGraph graph;
+    add_work_tasks(graph);
+    TaskGraph::Schedule predicted = mode == "heft" ? graph.plan(workers) : graph.simulate(workers);
+    {
+        std::osyncstream out(std::cout);
+        out << "Plan (" << mode << ", " << workers << " workers), predicted " << predicted.makespan << " s:\n";
+    }
+    print_schedule(graph, predicted);
+
+    auto t_start = clock::now();
+    uint64_t trace_start = trace::now_ns();
+
+    if (mode == "dynamic") {
+        graph.run(workers);
+    } else if (mode == "futures") {
+        ThreadPool pool(workers);
+        graph_futures(pool, slow, quick).get();
+    } else if (mode == "async") {
+        graph_async(slow, quick);
+    } else {
+        graph.run(predicted);
+    }
 
     auto t_end = clock::now();
     double seconds = std::chrono::duration<double>(t_end - t_start).count();
+    double bound = graph.critical_path();
+
+    print_completed(trace_start);
 
     {
         std::osyncstream out(std::cout);
         out << "Total time: " << seconds << " s\n";
+        out << "Predicted: " << predicted.makespan << " s (error " << seconds - predicted.makespan << " s)\n";
+        out << "Critical path: " << bound << " s (makespan / bound = " << seconds / bound << ")\n";
         out << "Work is done!\n";
     }
 }
 
+
+//       :   
+//  0..3   window , 20%  ""
+void add_random_tasks(TaskGraph& graph, size_t n, unsigned seed, size_t window = 64)
+{
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < n; ++i) {
+        std::vector<TaskGraph::TaskId> deps;
+        if (i > 0) {
+            size_t lo = i > window ? i - window : 0;
+            for (unsigned k = rng() % 4; k > 0; --k) {
+                auto d = TaskGraph::TaskId(lo + rng() % (i - lo));
+                if (std::find(deps.begin(), deps.end(), d) == deps.end()) deps.push_back(d);
+            }
+        }
+        double cost = rng() % 5 == 0 ? slow_seconds : quick_seconds;
+        graph.add("T" + std::to_string(i), cost, {}, std::move(deps));
+    }
+}
+
+//   :       1..max_workers 
+void dry_run(size_t tasks, int max_workers)
+{
+    using clock = std::chrono::steady_clock;
+    std::osyncstream out(std::cout);
+
+    TaskGraph lab;
+    add_work_tasks(lab);
+    out << "lab_5 graph: critical path " << lab.critical_path() << " s, total " << lab.total_cost() << " s\n";
+    for (int p = 1; p <= 3; ++p) {
+        out << "  " << p << " workers: heft " << lab.plan(p).makespan << " s, dynamic "
+            << lab.simulate(p).makespan << " s\n";
+    }
+
+    TaskGraph graph;
+    add_random_tasks(graph, tasks, 5);
+    double critical = graph.critical_path();
+    double total = graph.total_cost();
+    out << "random graph: " << tasks << " tasks, critical path " << critical << " s, total " << total << " s\n";
+    out << "workers,heft_s,dynamic_s,lower_bound_s,heft_efficiency,plan_ms\n";
+
+    double best = 0;
+    std::vector<std::pair<int, double>> heft;
+    for (int p = 1; p <= max_workers; p *= 2) {
+        auto t0 = clock::now();
+        auto planned = graph.plan(p);
+        double plan_ms = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+        auto dynamic = graph.simulate(p);
+
+        double bound = std::max(critical, total / p);
+        out << p << ',' << planned.makespan << ',' << dynamic.makespan << ',' << bound << ','
+            << total / (p * planned.makespan) << ',' << plan_ms << '\n';
+        heft.push_back({p, planned.makespan});
+        best = best == 0 ? planned.makespan : std::min(best, planned.makespan);
+    }
+
+    //   ,      5%  
+    for (auto [p, makespan] : heft) {
+        if (makespan <= best * 1.05) {
+            out << "suggested workers: " << p << " (" << makespan << " s)\n";
+            break;
+        }
+    }
+}
+
+//    : units   
+void spin(int units)
+{
+    uint64_t x = uint64_t(units);
+    for (int i = 0; i < units * 200; ++i) x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    bench::do_not_optimize(x);
+}
+
+void slow_spin(const std::string&) { spin(slow_seconds); }
+void quick_spin(const std::string&) { spin(quick_seconds); }
+
+//    graphs   : std::async (   
+//  ,      get())      workers 
+void bench_small_graphs(size_t graphs, int workers)
+{
+    bench::Options options;
+    options.warmup = 1;
+    options.samples = 5;
+
+    bench::Stats with_async = bench::run("graphs: std::async + get", [&] {
+        std::vector<std::future<void>> all;
+        all.reserve(graphs);
+        for (size_t i = 0; i < graphs; ++i) {
+            all.push_back(std::async(std::launch::async, [] { graph_async(slow_spin, quick_spin); }));
+        }
+        for (auto& f : all) f.get();
+    }, options);
+
+    ThreadPool pool(workers);
+    bench::Stats with_futures = bench::run("graphs: then / when_all", [&] {
+        std::vector<Future<void>> all;
+        all.reserve(graphs);
+        for (size_t i = 0; i < graphs; ++i) all.push_back(graph_futures(pool, slow_spin, quick_spin));
+        when_all(std::move(all)).get();
+    }, options);
+
+    std::osyncstream out(std::cout);
+    out << graphs << " graphs x 7 tasks\n"
+        << "std::async + get: " << with_async << ", " << graphs / with_async.median * 1000
+        << " graphs/s, " << 2 * graphs << " threads started\n"
+        << "then / when_all:  " << with_futures << ", " << graphs / with_futures.median * 1000
+        << " graphs/s, " << workers << " pool threads\n";
+}
+
 //  main
-int main()
+// : [heft | dynamic | futures | async] [ ,   2]
+//         dry-run [   ] [  ]
+//         graphs [   ] [  ]
+int main(int argc, char* argv[])
 {
-    work();
+    std::string mode = argc > 1 ? argv[1] : "heft";
+    if (mode == "dry-run") {
+        size_t tasks = argc > 2 ? std::stoul(argv[2]) : 10000;
+        int max_workers = argc > 3 ? std::max(1, std::atoi(argv[3])) : 64;
+        dry_run(tasks, max_workers);
+        return 0;
+    }
+    if (mode == "graphs") {
+        size_t graphs = argc > 2 ? std::stoul(argv[2]) : 1000;
+        int pool_threads = argc > 3 ? std::max(1, std::atoi(argv[3])) : int(std::max(1u, std::thread::hardware_concurrency()));
+        bench_small_graphs(graphs, pool_threads);
+        bench::default_report().write_csv("bench_results.csv");
+        bench::default_report().write_json("bench_results.json");
+        return 0;
+    }
+    //   lab_5 - 2  ,    
+    int workers = argc > 2 ? std::max(1, std::atoi(argv[2])) : 2;
+
+    //    ~17  (  A-B-C1-D1-F),       
+    bench::Options options;
+    options.warmup = 0;
+    options.samples = 3;
+
+    trace::collector().start();
+
+    bench::Stats stats = bench::run("work", [&] { work(mode, workers); }, options);
+
+    //     -  chrome://tracing / Perfetto
+    trace::collector().stop();
+    trace::collector().write_chrome_json("trace.json");
+    trace::collector().write_binary("trace.bin");
+
+    {
+        std::osyncstream out(std::cout);
+        out << "work(): " << stats << '\n';
+    }
+
+    bench::default_report().write_csv("bench_results.csv");
+    bench::default_report().write_json("bench_results.json");
     return 0;
 }
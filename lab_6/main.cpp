@@ -1,16 +1,183 @@
 #include <iostream>
 #include <coroutine>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "../common/bench.h"
+
+// --------------------    ------------------------------
+//      ( , promise, ).
+//   operator new      :
+//           
+//      .
+
+class FramePool {
+public:
+    static constexpr std::size_t granularity = 64;    //   
+    static constexpr std::size_t classes = 16;        //   1 ;  -  new
+    static constexpr std::size_t max_cached = 1024;   //       
+
+    static FramePool& local() {
+        thread_local FramePool pool;
+        return pool;
+    }
+
+    void* allocate(std::size_t bytes) {
+        std::size_t c = class_of(bytes);
+        if (c >= classes) return ::operator new(bytes);
+        if (FreeBlock* block = free_lists[c]) {
+            free_lists[c] = block->next;
+            --cached[c];
+            return block;
+        }
+        return ::operator new((c + 1) * granularity);
+    }
+
+    //       ,  ,   , -
+    //       
+    void deallocate(void* p, std::size_t bytes) noexcept {
+        std::size_t c = class_of(bytes);
+        if (c >= classes || cached[c] >= max_cached) {
+            ::operator delete(p);
+            return;
+        }
+        free_lists[c] = new (p) FreeBlock{ free_lists[c] };
+        ++cached[c];
+    }
+
+    FramePool() = default;
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    ~FramePool() {
+        for (FreeBlock*& head : free_lists) {
+            while (head) {
+                FreeBlock* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static std::size_t class_of(std::size_t bytes) {
+        return (bytes + granularity - 1) / granularity - 1;
+    }
+
+    FreeBlock* free_lists[classes] = {};
+    std::size_t cached[classes] = {};
+};
+
+//  : [][ ][ ,  ].
+// operator delete promise      ,   
+//    .
+namespace frame_alloc {
+
+constexpr std::size_t align = alignof(std::max_align_t);
+
+using Release = void (*)(void* frame, std::size_t size);
+
+struct alignas(align) Block {
+    std::byte bytes[align];
+};
+
+constexpr std::size_t round_up(std::size_t n) {
+    return (n + align - 1) / align * align;
+}
+
+inline Release& release_slot(void* frame, std::size_t size) {
+    return *reinterpret_cast<Release*>(static_cast<std::byte*>(frame) + round_up(size));
+}
+
+//     
+inline void* pooled(std::size_t size) {
+    void* frame = FramePool::local().allocate(round_up(size) + align);
+    release_slot(frame, size) = [](void* f, std::size_t s) {
+        FramePool::local().deallocate(f, round_up(s) + align);
+    };
+    return frame;
+}
+
+//   ,    (std::allocator_arg, alloc, ...)
+template <typename Alloc>
+void* with_allocator(const Alloc& alloc, std::size_t size) {
+    using Blocks = typename std::allocator_traits<Alloc>::template rebind_alloc<Block>;
+    static_assert(alignof(Blocks) <= align, "allocator is over-aligned");
+    constexpr std::size_t trailer = align + round_up(sizeof(Blocks));
+
+    Blocks blocks(alloc);
+    void* frame = std::allocator_traits<Blocks>::allocate(blocks, (round_up(size) + trailer) / align);
+    new (static_cast<std::byte*>(frame) + round_up(size) + align) Blocks(std::move(blocks));
+    release_slot(frame, size) = [](void* f, std::size_t s) {
+        auto* stored = reinterpret_cast<Blocks*>(static_cast<std::byte*>(f) + round_up(s) + align);
+        Blocks copy(std::move(*stored));
+        stored->~Blocks();
+        std::allocator_traits<Blocks>::deallocate(copy, static_cast<Block*>(f), (round_up(s) + trailer) / align);
+    };
+    return frame;
+}
+
+inline void release(void* frame, std::size_t size) noexcept {
+    release_slot(frame, size)(frame, size);
+}
+
+} // namespace frame_alloc
 
 // --------------------     ------------------------
+//    std::generator,  Ref ,   value():
+//  - Generator<T>: T&  ',      next().
+//     ' (co_yield T(...)  co_yield std::move(x))   -
+//    promise    ,      std::move(gen.value()),
+//     move-only . lvalue  (  )   
+//     awaiter,       ;
+//  - Generator<const T&>: const T&    ' -  lvalue,  
+//         ﳿ,     ;
+//  - Generator<T&>: T&  lvalue  -     .
+
+//   : pooled -       ,
+// heap -  ::operator new (    )
+enum class Frames { pooled, heap };
 
-template<typename T>
+template<typename Ref, Frames frames = Frames::pooled>
 class Generator {
 public:
+    using value_type = std::remove_cvref_t<Ref>;
+    using reference = std::conditional_t<std::is_reference_v<Ref>, Ref, Ref&>;
+
     struct promise_type {
-        T current_value{};
+        std::add_pointer_t<reference> current = nullptr;
         std::exception_ptr exception;
 
+        static void* operator new(std::size_t size) {
+            if constexpr (frames == Frames::heap) return ::operator new(size);
+            else return frame_alloc::pooled(size);
+        }
+
+        //   f(std::allocator_arg, alloc, ...) -   alloc
+        template <typename Alloc, typename... Args>
+            requires (frames == Frames::pooled)
+        static void* operator new(std::size_t size, std::allocator_arg_t, const Alloc& alloc, const Args&...) {
+            return frame_alloc::with_allocator(alloc, size);
+        }
+
+        static void operator delete(void* frame, std::size_t size) noexcept {
+            if constexpr (frames == Frames::heap) ::operator delete(frame, size);
+            else frame_alloc::release(frame, size);
+        }
+
         Generator get_return_object() {
             using handle_type = std::coroutine_handle<promise_type>;
             return Generator{ handle_type::from_promise(*this) };
@@ -19,16 +186,38 @@ public:
         std::suspend_always initial_suspend() noexcept { return {}; }
         std::suspend_always final_suspend() noexcept { return {}; }
 
-        std::suspend_always yield_value(T value) noexcept {
-            current_value = value;
+        // Generator<const T&> / Generator<T&>:  , ' (  )
+        //    
+        std::suspend_always yield_value(reference value) noexcept requires std::is_reference_v<Ref> {
+            current = std::addressof(value);
+            return {};
+        }
+
+        // Generator<T>:  '     -    
+        std::suspend_always yield_value(value_type&& value) noexcept requires (!std::is_reference_v<Ref>) {
+            current = std::addressof(value);
             return {};
         }
 
+        struct CopyAwaiter : std::suspend_always {
+            value_type copy;
+            promise_type* promise;
+            void await_suspend(std::coroutine_handle<>) noexcept { promise->current = std::addressof(copy); }
+        };
+
+        // Generator<T>, lvalue (   ) - ,    
+        CopyAwaiter yield_value(const value_type& value)
+            requires (!std::is_reference_v<Ref> && std::copy_constructible<value_type>) {
+            return CopyAwaiter{ {}, value, this };
+        }
+
+        //    '   -   
         void unhandled_exception() {
+            current = nullptr;
             exception = std::current_exception();
         }
 
-        void return_void() {}
+        void return_void() { current = nullptr; }
     };
 
     using handle_type = std::coroutine_handle<promise_type>;
@@ -57,9 +246,13 @@ public:
         return !coro.done();
     }
 
-    //  , "" co_yield
-    T value() const {
-        return coro.promise().current_value;
+    //  , "" co_yield (. Ref ).    next(),
+    //   true:   next()       -
+    // std::logic_error
+    reference value() const {
+        if (!coro || !coro.promise().current)
+            throw std::logic_error("Generator::value() called without a current value");
+        return *coro.promise().current;
     }
 
 private:
@@ -90,9 +283,136 @@ Generator<int> guessing_coroutine() {
     co_return;
 }
 
+// -------------------------- ̳ --------------------------------
+// ,     :    
+// (::operator new),   std::allocator    ,   move-only
+//   ,   T  .
+
+Generator<int> count_to(int n) {
+    for (int i = 0; i < n; ++i) co_yield i;
+}
+
+Generator<int, Frames::heap> count_to_heap(int n) {
+    for (int i = 0; i < n; ++i) co_yield i;
+}
+
+template <typename Alloc>
+Generator<int> count_to(std::allocator_arg_t, const Alloc&, int n) {
+    for (int i = 0; i < n; ++i) co_yield i;
+}
+
+Generator<std::unique_ptr<int>> owners(int n) {
+    for (int i = 0; i < n; ++i) co_yield std::make_unique<int>(i);
+}
+
+//  ﳿ,  ,  co_yield / value()   
+struct Payload {
+    static inline long copies = 0;
+    std::string text;
+
+    explicit Payload(std::string t) : text(std::move(t)) {}
+    Payload(const Payload& other) : text(other.text) { ++copies; }
+    Payload(Payload&&) noexcept = default;
+    Payload& operator=(const Payload& other) { text = other.text; ++copies; return *this; }
+    Payload& operator=(Payload&&) noexcept = default;
+};
+
+Generator<Payload> payloads(int n) {
+    for (int i = 0; i < n; ++i) co_yield Payload(std::string(32, char('a' + i % 26)));
+}
+
+//    -  ,  ﳿ
+Generator<const Payload&> payload_refs(int n) {
+    Payload current(std::string(32, 'a'));
+    for (int i = 0; i < n; ++i) {
+        current.text[0] = char('a' + i % 26);
+        co_yield current;
+    }
+}
+
+// false,     Payload  
+bool run_benchmark(int generators) {
+    constexpr int length = 8;   //    
+    bench::Options options;
+    options.warmup = 2;
+    options.samples = 15;
+
+    bench::Stats heap = bench::run("generator: heap frames", [&] {
+        long sum = 0;
+        for (int g = 0; g < generators; ++g) {
+            auto gen = count_to_heap(length);
+            while (gen.next()) sum += gen.value();
+        }
+        bench::do_not_optimize(sum);
+    }, options);
+
+    bench::Stats allocator = bench::run("generator: std::allocator frames", [&] {
+        long sum = 0;
+        for (int g = 0; g < generators; ++g) {
+            auto gen = count_to(std::allocator_arg, std::allocator<std::byte>{}, length);
+            while (gen.next()) sum += gen.value();
+        }
+        bench::do_not_optimize(sum);
+    }, options);
+
+    bench::Stats pooled = bench::run("generator: pooled frames", [&] {
+        long sum = 0;
+        for (int g = 0; g < generators; ++g) {
+            auto gen = count_to(length);
+            while (gen.next()) sum += gen.value();
+        }
+        bench::do_not_optimize(sum);
+    }, options);
+
+    bench::Stats moved = bench::run("generator: move-only values", [&] {
+        long sum = 0;
+        for (int g = 0; g < generators; ++g) {
+            auto gen = owners(length);
+            while (gen.next()) {
+                std::unique_ptr<int> owned = std::move(gen.value());
+                sum += *owned;
+            }
+        }
+        bench::do_not_optimize(sum);
+    }, options);
+
+    //  '  , lvalue   const-
+    Payload::copies = 0;
+    std::size_t chars = 0;
+    for (int g = 0; g < generators / 10; ++g) {
+        auto gen = payloads(length);
+        while (gen.next()) {
+            Payload taken = std::move(gen.value());
+            chars += taken.text.size();
+        }
+        auto refs = payload_refs(length);
+        while (refs.next()) chars += refs.value().text.size();
+    }
+    bench::do_not_optimize(chars);
+    long copies = Payload::copies;
+
+    auto per_generator_ns = [&](const bench::Stats& s) { return s.median * 1e6 / generators; };
+    std::cout << generators << " generators x " << length << " values\n"
+        << "heap frames:     " << heap << ", " << per_generator_ns(heap) << " ns per generator\n"
+        << "std::allocator:  " << allocator << ", " << per_generator_ns(allocator) << " ns per generator\n"
+        << "pooled frames:   " << pooled << ", " << per_generator_ns(pooled) << " ns per generator\n"
+        << "move-only:       " << moved << ", " << per_generator_ns(moved) << " ns per generator\n"
+        << "Payload copies while yielding " << 2 * (generators / 10) * length << " values: " << copies
+        << (copies == 0 ? "" : ", FAILED") << "\n";
+
+    bench::default_report().write_csv("bench_results.csv");
+    bench::default_report().write_json("bench_results.json");
+    return copies == 0;
+}
+
 // -------------------------- - --------------------------------
 
-int main() {
+// :   - ; bench [   ] -  
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        return run_benchmark(argc > 2 ? std::max(1, std::atoi(argv[2])) : 100000) ? 0 : 1;
+    }
+
     setlocale(LC_ALL, "Ukr");
     std::cout << " \" \" (1..100)\n";
     std::cout << "   .\n";